@@ -50,8 +50,27 @@ void init_core(py::module_ &m_core) {
         .def("get_num_objects", &RoleDenotation::get_num_objects)
     ;
 
+    py::class_<DenotationsCaches::Statistics>(m_core, "DenotationsCachesStatistics")
+        .def_readonly("num_hits", &DenotationsCaches::Statistics::num_hits)
+        .def_readonly("num_misses", &DenotationsCaches::Statistics::num_misses)
+        .def_readonly("num_evictions", &DenotationsCaches::Statistics::num_evictions)
+        .def_readonly("num_bytes", &DenotationsCaches::Statistics::num_bytes)
+    ;
+
     py::class_<DenotationsCaches>(m_core, "DenotationsCaches")
         .def(py::init<>())
+        .def("set_memory_limit", &DenotationsCaches::set_memory_limit)
+        .def("get_memory_limit", &DenotationsCaches::get_memory_limit)
+        .def("set_distances_memory_limit", &DenotationsCaches::set_distances_memory_limit)
+        .def("get_distances_memory_limit", &DenotationsCaches::get_distances_memory_limit)
+        .def("compute_memory_usage", &DenotationsCaches::compute_memory_usage)
+        .def("get_statistics", &DenotationsCaches::get_statistics)
+        .def("open_state_scope", &DenotationsCaches::open_state_scope)
+        .def("close_state_scope", &DenotationsCaches::close_state_scope)
+        .def("save", [](const DenotationsCaches& caches, const std::string& filename, const std::vector<std::shared_ptr<BaseElement>>& elements, const States& states) {
+            caches.save(filename, std::vector<std::shared_ptr<const BaseElement>>(elements.begin(), elements.end()), states);
+        })
+        .def("load", &DenotationsCaches::load)
     ;
 
     py::class_<Constant>(m_core, "Constant")
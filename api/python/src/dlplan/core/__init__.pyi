@@ -1,4 +1,4 @@
-from typing import Overload, List, Tuple
+from typing import Overload, Dict, List, Tuple
 
 
 class ConceptDenotation:
@@ -39,8 +39,25 @@ class RoleDenotation:
     def get_num_objects(self) -> int: ...
 
 
+class DenotationsCachesStatistics:
+    num_hits: int
+    num_misses: int
+    num_evictions: int
+    num_bytes: int
+
+
 class DenotationsCaches:
     def __init__(self) -> None: ...
+    def set_memory_limit(self, num_bytes: int) -> None: ...
+    def get_memory_limit(self) -> int: ...
+    def set_distances_memory_limit(self, num_bytes: int) -> None: ...
+    def get_distances_memory_limit(self) -> int: ...
+    def compute_memory_usage(self) -> int: ...
+    def get_statistics(self) -> Dict[str, DenotationsCachesStatistics]: ...
+    def open_state_scope(self, state: State) -> None: ...
+    def close_state_scope(self, state: State) -> None: ...
+    def save(self, filename: str, elements: List[BaseElement], states: List[State]) -> None: ...
+    def load(self, filename: str) -> None: ...
 
 
 class Constant:
@@ -1,9 +1,22 @@
-from typing import List
+from typing import List, overload
 
-from ..core import SyntacticElementFactory, State
+from ..core import SyntacticElementFactory, State, DenotationsCaches
 
 
 class FeatureGenerator:
+    @overload
+    def generate(self, 
+        factory: SyntacticElementFactory, 
+        states: List[State],
+        caches: DenotationsCaches,
+        concept_complexity_limit: int = 9,
+        role_complexity_limit: int = 9,
+        boolean_complexity_limit: int = 9,
+        count_numerical_complexity_limit: int = 9,
+        distance_numerical_complexity_limit: int = 9,
+        time_limit: int = 3600,
+        feature_limit: int = 10000) -> List[str]: ...
+    @overload
     def generate(self, 
         factory: SyntacticElementFactory, 
         states: List[State],
@@ -14,7 +14,8 @@ using namespace dlplan::generator;
 void init_generator(py::module_ &m_generator) {
     py::class_<FeatureGenerator, std::shared_ptr<FeatureGenerator>>(m_generator, "FeatureGenerator")
         .def(py::init<>())
-        .def("generate", &FeatureGenerator::generate, py::arg("factory"), py::arg("states"), py::arg("concept_complexity_limit") = 9, py::arg("role_complexity_limit") = 9, py::arg("boolean_complexity_limit") = 9, py::arg("count_numerical_complexity_limit") = 9, py::arg("distance_numerical_complexity_limit") = 9, py::arg("time_limit") = 3600, py::arg("feature_limit") = 10000)
+        .def("generate", py::overload_cast<dlplan::core::SyntacticElementFactory&, const dlplan::core::States&, dlplan::core::DenotationsCaches&, int, int, int, int, int, int, int>(&FeatureGenerator::generate), py::arg("factory"), py::arg("states"), py::arg("caches"), py::arg("concept_complexity_limit") = 9, py::arg("role_complexity_limit") = 9, py::arg("boolean_complexity_limit") = 9, py::arg("count_numerical_complexity_limit") = 9, py::arg("distance_numerical_complexity_limit") = 9, py::arg("time_limit") = 3600, py::arg("feature_limit") = 10000)
+        .def("generate", py::overload_cast<dlplan::core::SyntacticElementFactory&, const dlplan::core::States&, int, int, int, int, int, int, int>(&FeatureGenerator::generate), py::arg("factory"), py::arg("states"), py::arg("concept_complexity_limit") = 9, py::arg("role_complexity_limit") = 9, py::arg("boolean_complexity_limit") = 9, py::arg("count_numerical_complexity_limit") = 9, py::arg("distance_numerical_complexity_limit") = 9, py::arg("time_limit") = 3600, py::arg("feature_limit") = 10000)
         .def("set_generate_empty_boolean", &FeatureGenerator::set_generate_empty_boolean)
         .def("set_generate_inclusion_boolean", &FeatureGenerator::set_generate_inclusion_boolean)
         .def("set_generate_nullary_boolean", &FeatureGenerator::set_generate_nullary_boolean)
@@ -1,3 +1,6 @@
+import os
+import tempfile
+
 from dlplan.core import VocabularyInfo, InstanceInfo, \
     SyntacticElementFactory, State, DenotationsCaches
 
@@ -53,3 +56,103 @@ def test_caching():
     assert [boolean_0.evaluate(state_0), boolean_0.evaluate(state_1)] == \
         boolean_0.evaluate([state_0, state_1], caches)
     assert boolean_0.evaluate([state_0, state_1], caches) == boolean_0.evaluate([state_0, state_1], caches)
+
+
+def test_caching_memory_limit():
+    vocabulary = VocabularyInfo()
+    predicate_0 = vocabulary.add_predicate("role", 2)
+    instance = InstanceInfo(vocabulary, index=0)
+    atom_0 = instance.add_atom("role", ["A", "B"])
+
+    state_0 = State(instance, [], index=0)
+    state_1 = State(instance, [atom_0], index=1)
+
+    factory = SyntacticElementFactory(vocabulary)
+    caches = DenotationsCaches()
+    caches.set_memory_limit(1)
+    assert caches.get_memory_limit() == 1
+    caches.set_distances_memory_limit(0)
+    assert caches.get_distances_memory_limit() == 0
+
+    numerical_0 = factory.parse_numerical("n_count(c_primitive(role, 0))")
+    assert numerical_0.evaluate(state_0, caches) == 0
+    assert numerical_0.evaluate(state_1, caches) == 1
+    assert numerical_0.evaluate(state_1, caches) == 1
+    statistics = caches.get_statistics()
+    assert statistics["numerical_denotation"].num_hits == 1
+    assert statistics["numerical_denotation"].num_evictions > 0
+    assert caches.compute_memory_usage() >= 0
+
+
+def test_caching_state_scope():
+    vocabulary = VocabularyInfo()
+    predicate_0 = vocabulary.add_predicate("role", 2)
+    instance = InstanceInfo(vocabulary, index=0)
+    atom_0 = instance.add_atom("role", ["A", "B"])
+
+    state_0 = State(instance, [], index=0)
+    state_1 = State(instance, [atom_0], index=1)
+
+    factory = SyntacticElementFactory(vocabulary)
+    caches = DenotationsCaches()
+
+    numerical_0 = factory.parse_numerical("n_count(c_primitive(role, 0))")
+    caches.open_state_scope(state_0)
+    assert numerical_0.evaluate(state_0, caches) == 0
+    caches.close_state_scope(state_0)
+    memory_usage = caches.compute_memory_usage()
+    caches.open_state_scope(state_1)
+    assert numerical_0.evaluate(state_1, caches) == 1
+    caches.close_state_scope(state_1)
+    assert caches.compute_memory_usage() == memory_usage
+
+
+def test_caching_persistent():
+    vocabulary = VocabularyInfo()
+    predicate_0 = vocabulary.add_predicate("role", 2)
+    instance = InstanceInfo(vocabulary, index=0)
+    atom_0 = instance.add_atom("role", ["A", "B"])
+
+    state_0 = State(instance, [], index=0)
+    state_1 = State(instance, [atom_0], index=1)
+
+    filename = os.path.join(tempfile.mkdtemp(), "caches.bin")
+    factory = SyntacticElementFactory(vocabulary)
+    numerical_0 = factory.parse_numerical("n_count(c_primitive(role, 0))")
+    caches = DenotationsCaches()
+    assert numerical_0.evaluate(state_0, caches) == 0
+    assert numerical_0.evaluate(state_1, caches) == 1
+    caches.save(filename, [numerical_0], [state_0, state_1])
+
+    factory = SyntacticElementFactory(vocabulary)
+    numerical_0 = factory.parse_numerical("n_count(c_primitive(role, 0))")
+    caches = DenotationsCaches()
+    caches.load(filename)
+    assert numerical_0.evaluate(state_0, caches) == 0
+    assert numerical_0.evaluate(state_1, caches) == 1
+    assert caches.get_statistics()["concept_denotation"].num_misses == 0
+    os.remove(filename)
+
+
+def test_caching_persistent_batched():
+    vocabulary = VocabularyInfo()
+    predicate_0 = vocabulary.add_predicate("role", 2)
+    instance = InstanceInfo(vocabulary, index=0)
+    atom_0 = instance.add_atom("role", ["A", "B"])
+
+    states = [State(instance, [], index=0), State(instance, [atom_0], index=1)]
+
+    filename = os.path.join(tempfile.mkdtemp(), "caches.bin")
+    factory = SyntacticElementFactory(vocabulary)
+    numerical_0 = factory.parse_numerical("n_count(c_primitive(role, 0))")
+    caches = DenotationsCaches()
+    assert numerical_0.evaluate(states, caches) == [0, 1]
+    caches.save(filename, [numerical_0], states)
+
+    factory = SyntacticElementFactory(vocabulary)
+    numerical_0 = factory.parse_numerical("n_count(c_primitive(role, 0))")
+    caches = DenotationsCaches()
+    caches.load(filename)
+    assert numerical_0.evaluate(states, caches) == [0, 1]
+    assert caches.get_statistics()["concept_denotations"].num_misses == 0
+    os.remove(filename)
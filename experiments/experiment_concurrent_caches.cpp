@@ -0,0 +1,117 @@
+#include <vector>
+#include <iostream>
+#include <chrono>
+#include <random>
+#include <string>
+#include <thread>
+
+#include "../include/dlplan/core.h"
+
+using namespace dlplan;
+
+
+/*
+  Benchmark of DenotationsCaches shared by threads against one private
+  caches per thread and the default caches with a single thread.
+
+  Each thread evaluates all features on its share of the states twice,
+  i.e., the second pass only hits the caches. Threads that share the
+  caches also share the denotations of subexpressions across states.
+*/
+
+template<typename F>
+static long long time_in_microseconds(F&& function) {
+    auto start = std::chrono::steady_clock::now();
+    function();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+}
+
+int main(int argc, char** argv) {
+    if (argc != 4) {
+        std::cout << "User error. Expected: ./experiment_concurrent_caches <int:num_states> <int:num_objects> <int:max_num_threads>" << std::endl;
+        return 1;
+    }
+    int num_states = std::atoi(argv[1]);
+    int num_objects = std::atoi(argv[2]);
+    int max_num_threads = std::atoi(argv[3]);
+    auto vocabulary = std::make_shared<core::VocabularyInfo>();
+    vocabulary->add_predicate("conn", 2, true);
+    vocabulary->add_predicate("at", 1);
+    vocabulary->add_predicate("painted", 1);
+    vocabulary->add_predicate("on", 2);
+    auto instance = std::make_shared<core::InstanceInfo>(vocabulary, 0);
+    std::vector<core::Atom> at_atoms, painted_atoms, on_atoms;
+    for (int i = 0; i < num_objects; ++i) {
+        std::string object = "o" + std::to_string(i);
+        std::string next_object = "o" + std::to_string(i + 1);
+        at_atoms.push_back(instance->add_atom("at", {object}));
+        painted_atoms.push_back(instance->add_atom("painted", {object}));
+        if (i + 1 < num_objects) {
+            instance->add_static_atom("conn", {object, next_object});
+            on_atoms.push_back(instance->add_atom("on", {object, next_object}));
+        }
+    }
+    std::mt19937 generator(0);
+    std::vector<core::State> states;
+    for (int i = 0; i < num_states; ++i) {
+        std::vector<core::Atom> atoms;
+        for (const auto& atom : at_atoms) if (generator() % 5 == 0) atoms.push_back(atom);
+        for (const auto& atom : painted_atoms) if (generator() % 2 == 0) atoms.push_back(atom);
+        for (const auto& atom : on_atoms) if (generator() % 3 == 0) atoms.push_back(atom);
+        states.emplace_back(instance, atoms, i);
+    }
+
+    core::SyntacticElementFactory factory(vocabulary);
+    std::vector<std::shared_ptr<const core::Numerical>> numericals;
+    std::vector<std::string> concepts{"c_primitive(at,0)", "c_primitive(painted,0)", "c_primitive(on,0)", "c_primitive(on,1)", "c_top"};
+    std::vector<std::string> roles{"r_primitive(conn,0,1)", "r_primitive(on,0,1)", "r_inverse(r_primitive(on,0,1))", "r_transitive_closure(r_primitive(on,0,1))"};
+    for (const auto& role : roles) {
+        for (const auto& concept_ : concepts) {
+            numericals.push_back(factory.parse_numerical("n_count(c_some(" + role + "," + concept_ + "))"));
+            numericals.push_back(factory.parse_numerical("n_count(c_all(" + role + "," + concept_ + "))"));
+        }
+    }
+
+    auto evaluate = [&](int thread, int num_threads, core::DenotationsCaches& caches, long long& checksum) {
+        for (int pass = 0; pass < 2; ++pass) {
+            for (int i = thread; i < num_states; i += num_threads) {
+                for (const auto& numerical : numericals) checksum += numerical->evaluate(states[i], caches);
+            }
+        }
+    };
+
+    std::cout << "num_states=" << num_states << " num_objects=" << num_objects
+              << " num_features=" << numericals.size() << std::endl;
+    // Checksum prevents the compiler from removing the benchmarked code.
+    long long checksum = 0;
+    std::cout << "Time default caches with 1 thread: " << time_in_microseconds([&](){
+        core::DenotationsCaches caches;
+        evaluate(0, 1, caches, checksum);
+    }) << "us" << std::endl;
+    for (int num_threads = 1; num_threads <= max_num_threads; num_threads *= 2) {
+        std::vector<long long> checksums(num_threads, 0);
+        long long shared = time_in_microseconds([&](){
+            core::DenotationsCaches caches(64);
+            std::vector<std::thread> threads;
+            for (int t = 0; t < num_threads; ++t) {
+                threads.emplace_back([&, t](){ evaluate(t, num_threads, caches, checksums[t]); });
+            }
+            for (auto& thread : threads) thread.join();
+        });
+        long long separate = time_in_microseconds([&](){
+            std::vector<core::DenotationsCaches> caches(num_threads);
+            std::vector<std::thread> threads;
+            for (int t = 0; t < num_threads; ++t) {
+                threads.emplace_back([&, t](){ evaluate(t, num_threads, caches[t], checksums[t]); });
+            }
+            for (auto& thread : threads) thread.join();
+        });
+        for (long long value : checksums) checksum += value;
+        std::cout << "num_threads=" << num_threads << std::endl
+                  << "    Time shared concurrent caches:   " << shared << "us" << std::endl
+                  << "    Time private caches per thread:  " << separate << "us" << std::endl;
+    }
+    std::cout << "Checksum: " << checksum << std::endl;
+    return 0;
+}
@@ -0,0 +1,92 @@
+#include <vector>
+#include <iostream>
+#include <chrono>
+#include <random>
+
+#include "../include/dlplan/core.h"
+
+using namespace dlplan;
+
+
+/*
+  Benchmark of batched denotations over all states of an element.
+
+  Compares the per-state evaluation of c_and, c_or, c_diff, and c_not
+  as done by Concept::evaluate(const States&, DenotationsCaches&), i.e.,
+  one cached denotation per state and a hash over the pointers, against
+  a single ConceptDenotationMatrix per element.
+*/
+
+template<typename F>
+static long long time_in_microseconds(int num_iterations, F&& function) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < num_iterations; ++i) {
+        function();
+    }
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+}
+
+static core::ConceptDenotations make_denotations(int num_states, int num_objects, std::mt19937& generator, core::DenotationsCaches& caches) {
+    std::bernoulli_distribution distribution(0.3);
+    core::ConceptDenotations result;
+    for (int i = 0; i < num_states; ++i) {
+        core::ConceptDenotation denotation(num_objects);
+        for (int j = 0; j < num_objects; ++j) {
+            if (distribution(generator)) denotation.insert(j);
+        }
+        result.push_back(caches.get_concept_denotation_cache().insert_denotation(std::move(denotation)));
+    }
+    return result;
+}
+
+int main(int argc, char** argv) {
+    if (argc != 4) {
+        std::cout << "User error. Expected: ./experiment_denotation_matrix <int:num_states> <int:num_objects> <int:num_iterations>" << std::endl;
+        return 1;
+    }
+    int num_states = std::atoi(argv[1]);
+    int num_objects = std::atoi(argv[2]);
+    int num_iterations = std::atoi(argv[3]);
+    std::mt19937 generator(0);
+    core::DenotationsCaches caches;
+    auto left = make_denotations(num_states, num_objects, generator, caches);
+    auto right = make_denotations(num_states, num_objects, generator, caches);
+    core::ConceptDenotationMatrix left_matrix(left);
+    core::ConceptDenotationMatrix right_matrix(right);
+    // Checksum prevents the compiler from removing the benchmarked code.
+    std::size_t checksum = 0;
+
+    long long per_state = time_in_microseconds(num_iterations, [&](){
+        for (int op = 0; op < 4; ++op) {
+            core::ConceptDenotations denotations;
+            denotations.reserve(num_states);
+            for (int i = 0; i < num_states; ++i) {
+                core::ConceptDenotation denotation = *left[i];
+                if (op == 0) denotation &= *right[i];
+                else if (op == 1) denotation |= *right[i];
+                else if (op == 2) denotation -= *right[i];
+                else ~denotation;
+                denotations.push_back(caches.get_concept_denotation_cache().insert_denotation(std::move(denotation)));
+            }
+            checksum += core::hash<core::ConceptDenotations>()(denotations);
+        }
+    });
+    long long batched = time_in_microseconds(num_iterations, [&](){
+        for (int op = 0; op < 4; ++op) {
+            core::ConceptDenotationMatrix matrix = left_matrix;
+            if (op == 0) matrix &= right_matrix;
+            else if (op == 1) matrix |= right_matrix;
+            else if (op == 2) matrix -= right_matrix;
+            else ~matrix;
+            checksum += matrix.hash();
+        }
+    });
+    std::cout << "num_states=" << num_states << " num_objects=" << num_objects << std::endl
+              << "Time and, or, diff, not per state:   " << per_state << "us" << std::endl
+              << "Time and, or, diff, not batched:     " << batched << "us" << std::endl
+              << "Memory of matrix:                    " << left_matrix.compute_memory_usage() << " bytes" << std::endl
+              << "Memory of pointers to denotations:   " << left.size() * sizeof(const core::ConceptDenotation*) << " bytes" << std::endl
+              << "Checksum: " << checksum << std::endl;
+    return 0;
+}
@@ -0,0 +1,138 @@
+#include <vector>
+#include <iostream>
+#include <chrono>
+#include <random>
+
+#include "../include/dlplan/core.h"
+
+using namespace dlplan;
+
+
+/*
+  Microbenchmark for the word-level DynamicBitset operations.
+  Compares counting and iterating set bits of role denotations
+  bit by bit against popcount and find_first/find_next, and the
+  set algebra with scalar 32-bit blocks against the vectorized
+  64-bit block kernels, and hashing with hash_combine per block
+  against MurmurHash3.
+*/
+
+using Bitset = utils::DynamicBitset<std::uint64_t>;
+using Bitset32 = utils::DynamicBitset<unsigned>;
+
+static int count_bitwise(const Bitset& bitset) {
+    int result = 0;
+    for (std::size_t pos = 0; pos < bitset.size(); ++pos) {
+        result += static_cast<int>(bitset.test(pos));
+    }
+    return result;
+}
+
+static core::PairsOfObjectIndices to_vector_bitwise(const Bitset& bitset, int num_objects) {
+    core::PairsOfObjectIndices result;
+    for (int i = 0; i < num_objects; ++i) {
+        for (int j = 0; j < num_objects; ++j) {
+            if (bitset.test(i * num_objects + j)) {
+                result.emplace_back(i, j);
+            }
+        }
+    }
+    return result;
+}
+
+static core::PairsOfObjectIndices to_vector_wordwise(const Bitset& bitset, int num_objects) {
+    core::PairsOfObjectIndices result;
+    result.reserve(bitset.count());
+    for (auto pos = bitset.find_first(); pos != bitset.npos; pos = bitset.find_next(pos)) {
+        result.emplace_back(pos / num_objects, pos % num_objects);
+    }
+    return result;
+}
+
+static std::size_t hash_combine_blocks(const Bitset& bitset) {
+    std::size_t seed = bitset.num_blocks();
+    for (std::size_t i = 0; i < bitset.num_blocks(); ++i) {
+        utils::hash_combine(seed, bitset.data()[i]);
+    }
+    return seed;
+}
+
+template<typename B>
+static long long time_set_algebra(int num_iterations, const B& left, const B& right, long long& checksum) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < num_iterations; ++i) {
+        B result = left;
+        result &= right;
+        result |= left;
+        result -= right;
+        ~result;
+        checksum += result.intersects(right) + left.is_subset_of(result);
+    }
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+}
+
+template<typename F>
+static long long time_in_microseconds(int num_iterations, F&& function) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < num_iterations; ++i) {
+        function();
+    }
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+}
+
+
+int main(int argc, char** argv) {
+    if (argc != 2) {
+        std::cout << "User error. Expected: ./experiment_dynamic_bitset <int:num_iterations>" << std::endl;
+        return 1;
+    }
+    int num_iterations = std::atoi(argv[1]);
+    std::cout << "Bitset kernels: " << utils::bitset_kernels::get_instruction_set() << std::endl;
+    std::mt19937 generator(0);
+    // Checksum prevents the compiler from removing the benchmarked code.
+    long long checksum = 0;
+    for (int num_objects : {200, 500, 1000}) {
+        for (double density : {0.001, 0.01, 0.1, 0.5}) {
+            Bitset bitset(num_objects * num_objects);
+            Bitset other_bitset(num_objects * num_objects);
+            Bitset32 bitset_32(num_objects * num_objects);
+            Bitset32 other_bitset_32(num_objects * num_objects);
+            core::RoleDenotation denotation(num_objects);
+            std::bernoulli_distribution distribution(density);
+            for (int i = 0; i < num_objects; ++i) {
+                for (int j = 0; j < num_objects; ++j) {
+                    if (distribution(generator)) {
+                        bitset.set(i * num_objects + j);
+                        bitset_32.set(i * num_objects + j);
+                        denotation.insert(std::make_pair(i, j));
+                    }
+                    if (distribution(generator)) {
+                        other_bitset.set(i * num_objects + j);
+                        other_bitset_32.set(i * num_objects + j);
+                    }
+                }
+            }
+            if (count_bitwise(bitset) != bitset.count()
+                || to_vector_bitwise(bitset, num_objects) != to_vector_wordwise(bitset, num_objects)
+                || to_vector_bitwise(bitset, num_objects) != denotation.to_sorted_vector()) {
+                std::cout << "Mismatch between bitwise and wordwise results." << std::endl;
+                return 1;
+            }
+            std::cout << "num_objects=" << num_objects << " density=" << density << " set_bits=" << bitset.count() << std::endl
+                << "    count bitwise:          " << time_in_microseconds(num_iterations, [&](){ checksum += count_bitwise(bitset); }) << "us" << std::endl
+                << "    count popcount:         " << time_in_microseconds(num_iterations, [&](){ checksum += bitset.count(); }) << "us" << std::endl
+                << "    RoleDenotation::size:   " << time_in_microseconds(num_iterations, [&](){ checksum += denotation.size(); }) << "us" << std::endl
+                << "    to_vector bitwise:      " << time_in_microseconds(num_iterations, [&](){ checksum += to_vector_bitwise(bitset, num_objects).size(); }) << "us" << std::endl
+                << "    to_vector find_next:    " << time_in_microseconds(num_iterations, [&](){ checksum += to_vector_wordwise(bitset, num_objects).size(); }) << "us" << std::endl
+                << "    RoleDenotation::to_vector: " << time_in_microseconds(num_iterations, [&](){ checksum += denotation.to_vector().size(); }) << "us" << std::endl
+                << "    set algebra 32-bit scalar: " << time_set_algebra(num_iterations, bitset_32, other_bitset_32, checksum) << "us" << std::endl
+                << "    set algebra 64-bit kernels: " << time_set_algebra(num_iterations, bitset, other_bitset, checksum) << "us" << std::endl
+                << "    hash hash_combine:      " << time_in_microseconds(num_iterations, [&](){ checksum += hash_combine_blocks(bitset); }) << "us" << std::endl
+                << "    hash MurmurHash3:       " << time_in_microseconds(num_iterations, [&](){ checksum += bitset.hash(); }) << "us" << std::endl;
+        }
+    }
+    std::cout << "Checksum: " << checksum << std::endl;
+    return 0;
+}
@@ -0,0 +1,99 @@
+#include <vector>
+#include <iostream>
+#include <chrono>
+#include <random>
+#include <string>
+
+#include "../include/dlplan/core.h"
+
+using namespace dlplan;
+
+
+/*
+  Benchmark of EvaluationProgram against evaluating each feature of a
+  policy separately on states that are seen only once, i.e., the
+  evaluation during search.
+
+  Features are c_some, c_all, and c_and over combinations of a few
+  concepts and roles such that subexpressions are shared.
+*/
+
+int main(int argc, char** argv) {
+    if (argc != 3) {
+        std::cout << "User error. Expected: ./experiment_evaluation_program <int:num_states> <int:num_objects>" << std::endl;
+        return 1;
+    }
+    int num_states = std::atoi(argv[1]);
+    int num_objects = std::atoi(argv[2]);
+    auto vocabulary = std::make_shared<core::VocabularyInfo>();
+    vocabulary->add_predicate("conn", 2, true);
+    vocabulary->add_predicate("at", 1);
+    vocabulary->add_predicate("painted", 1);
+    vocabulary->add_predicate("on", 2);
+    auto instance = std::make_shared<core::InstanceInfo>(vocabulary, 0);
+    std::vector<core::Atom> at_atoms, painted_atoms, on_atoms;
+    for (int i = 0; i < num_objects; ++i) {
+        std::string object = "o" + std::to_string(i);
+        std::string next_object = "o" + std::to_string(i + 1);
+        at_atoms.push_back(instance->add_atom("at", {object}));
+        painted_atoms.push_back(instance->add_atom("painted", {object}));
+        if (i + 1 < num_objects) {
+            instance->add_static_atom("conn", {object, next_object});
+            on_atoms.push_back(instance->add_atom("on", {object, next_object}));
+        }
+    }
+    std::mt19937 generator(0);
+    std::vector<core::State> states;
+    for (int i = 0; i < num_states; ++i) {
+        std::vector<core::Atom> atoms;
+        for (const auto& atom : at_atoms) if (generator() % 5 == 0) atoms.push_back(atom);
+        for (const auto& atom : painted_atoms) if (generator() % 2 == 0) atoms.push_back(atom);
+        for (const auto& atom : on_atoms) if (generator() % 3 == 0) atoms.push_back(atom);
+        states.emplace_back(instance, atoms, i);
+    }
+
+    core::SyntacticElementFactory factory(vocabulary);
+    std::vector<std::shared_ptr<const core::Boolean>> booleans;
+    std::vector<std::shared_ptr<const core::Numerical>> numericals;
+    std::vector<std::string> concepts{"c_primitive(at,0)", "c_primitive(painted,0)", "c_primitive(on,0)", "c_primitive(on,1)", "c_top"};
+    std::vector<std::string> roles{"r_primitive(conn,0,1)", "r_primitive(on,0,1)", "r_inverse(r_primitive(on,0,1))", "r_transitive_closure(r_primitive(on,0,1))"};
+    for (const auto& role : roles) {
+        for (const auto& concept_ : concepts) {
+            numericals.push_back(factory.parse_numerical("n_count(c_some(" + role + "," + concept_ + "))"));
+            numericals.push_back(factory.parse_numerical("n_count(c_all(" + role + "," + concept_ + "))"));
+            booleans.push_back(factory.parse_boolean("b_empty(c_and(c_some(" + role + "," + concept_ + "),c_primitive(painted,0)))"));
+        }
+    }
+    for (const auto& concept_ : concepts) {
+        numericals.push_back(factory.parse_numerical("n_concept_distance(c_primitive(at,0),r_primitive(conn,0,1)," + concept_ + ")"));
+    }
+
+    // Checksum prevents the compiler from removing the benchmarked code.
+    long long checksum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (const auto& state : states) {
+        for (const auto& boolean : booleans) checksum += boolean->evaluate(state);
+        for (const auto& numerical : numericals) checksum += numerical->evaluate(state);
+    }
+    auto end = std::chrono::steady_clock::now();
+    long long separate = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+
+    start = std::chrono::steady_clock::now();
+    core::EvaluationProgram program(booleans, numericals);
+    for (const auto& state : states) {
+        program.evaluate(state);
+        for (bool denotation : program.get_boolean_denotations()) checksum += denotation;
+        for (int denotation : program.get_numerical_denotations()) checksum += denotation;
+    }
+    end = std::chrono::steady_clock::now();
+    long long compiled = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+
+    std::cout << "num_states=" << num_states << " num_objects=" << num_objects
+              << " num_features=" << booleans.size() + numericals.size() << std::endl
+              << "Number of instructions:       " << program.get_num_instructions() << std::endl
+              << "Number of registers:          " << program.get_num_registers() << std::endl
+              << "Time evaluate per feature:    " << separate << "us" << std::endl
+              << "Time EvaluationProgram:       " << compiled << "us" << std::endl
+              << "Checksum: " << checksum << std::endl;
+    return 0;
+}
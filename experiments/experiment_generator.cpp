@@ -1,3 +1,6 @@
+#include <atomic>
+#include <cstdlib>
+#include <new>
 #include <vector>
 #include <iostream>
 #include <chrono>
@@ -5,10 +8,36 @@
 #include "../include/dlplan/core.h"
 #include "../include/dlplan/generator.h"
 #include "../include/dlplan/state_space.h"
+#include "../src/utils/system.h"
 
 using namespace dlplan;
 
 
+/*
+  Replacements of the global allocation functions that count the number
+  of heap allocations, e.g., to measure the effect of arena storage.
+*/
+static std::atomic<long long> num_allocations{0};
+
+void* operator new(std::size_t size) {
+    ++num_allocations;
+    if (void* ptr = std::malloc(size ? size : 1)) return ptr;
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    ++num_allocations;
+    std::size_t align = static_cast<std::size_t>(alignment);
+    if (void* ptr = std::aligned_alloc(align, (size + align - 1) / align * align)) return ptr;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::align_val_t) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept { std::free(ptr); }
+
+
 int main(int argc, char** argv) {
     std::cout << argc << std::endl;
     for (int i = 0; i < argc; ++i) {
@@ -54,6 +83,8 @@ int main(int argc, char** argv) {
     feature_generator.set_generate_transitive_reflexive_closure_role(false);
     core::States states;
     std::for_each(state_space.get_states().begin(), state_space.get_states().end(), [&](const auto& pair){ states.push_back(pair.second); });
+    long long num_allocations_before_generate = num_allocations;
+    auto generate_start = std::chrono::steady_clock::now();
     auto feature_reprs = feature_generator.generate(
         syntactic_element_factory,
         states,
@@ -64,6 +95,12 @@ int main(int argc, char** argv) {
         distance_numerical_complexity_limit,
         time_limit,
         feature_limit);
+    auto generate_end = std::chrono::steady_clock::now();
+    std::cout << "Time generate features: "
+        << std::chrono::duration_cast<std::chrono::milliseconds>(generate_end - generate_start).count()
+        << "ms" << std::endl;
+    std::cout << "Number of allocations in generate features: " << num_allocations - num_allocations_before_generate << std::endl;
+    std::cout << "Peak memory after generate features: " << utils::get_peak_memory_in_kb() << " KB" << std::endl;
 
     std::vector<std::shared_ptr<const core::Boolean>> boolean_features;
     std::vector<std::shared_ptr<const core::Numerical>> numerical_features;
@@ -0,0 +1,82 @@
+#include <vector>
+#include <iostream>
+#include <chrono>
+#include <random>
+
+#include "../include/dlplan/utils/dynamic_bitset.h"
+
+using namespace dlplan;
+
+
+/*
+  Benchmark of incremental hashing against full rehashing of DynamicBitset.
+
+  Mimics the generator workload on bit matrices of role denotations:
+  primitive denotations are built by inserting single pairs, composite
+  denotations by bulk operations and row operations, and every resulting
+  denotation is hashed once when it is inserted into the caches.
+*/
+
+template<typename Bitset>
+static long long run_workload(int num_iterations, int num_objects, const std::vector<std::size_t>& positions, std::size_t& checksum) {
+    const std::size_t num_blocks_per_row = (num_objects + 63) / 64;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < num_iterations; ++i) {
+        // primitive roles
+        Bitset left(num_objects * num_blocks_per_row * 64);
+        Bitset right(num_objects * num_blocks_per_row * 64);
+        for (std::size_t j = 0; j < positions.size(); ++j) {
+            (j % 2 ? left : right).set(positions[j]);
+        }
+        checksum += left.hash() + right.hash();
+        // r_and, r_or, r_diff, r_not
+        Bitset conjunction = left;
+        conjunction &= right;
+        Bitset disjunction = left;
+        disjunction |= right;
+        Bitset difference = left;
+        difference -= right;
+        Bitset negation = left;
+        ~negation;
+        checksum += conjunction.hash() + disjunction.hash() + difference.hash() + negation.hash();
+        // r_compose with one row operation per source
+        Bitset composition(num_objects * num_blocks_per_row * 64);
+        for (int source = 0; source < num_objects; ++source) {
+            composition.or_assign(source * num_blocks_per_row, right.data() + ((source * 7) % num_objects) * num_blocks_per_row, num_blocks_per_row);
+        }
+        checksum += composition.hash();
+    }
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+}
+
+
+int main(int argc, char** argv) {
+    if (argc != 2) {
+        std::cout << "User error. Expected: ./experiment_incremental_hash <int:num_iterations>" << std::endl;
+        return 1;
+    }
+    int num_iterations = std::atoi(argv[1]);
+    std::mt19937 generator(0);
+    // Checksum prevents the compiler from removing the benchmarked code.
+    std::size_t checksum = 0;
+    for (int num_objects : {50, 200, 500}) {
+        for (double density : {0.001, 0.01, 0.1}) {
+            const std::size_t row_size = ((num_objects + 63) / 64) * 64;
+            std::bernoulli_distribution distribution(density);
+            std::vector<std::size_t> positions;
+            for (int source = 0; source < num_objects; ++source) {
+                for (int target = 0; target < num_objects; ++target) {
+                    if (distribution(generator)) {
+                        positions.push_back(source * row_size + target);
+                    }
+                }
+            }
+            std::cout << "num_objects=" << num_objects << " density=" << density << std::endl
+                << "    full rehash:        " << run_workload<utils::DynamicBitset<std::uint64_t, 0, false>>(num_iterations, num_objects, positions, checksum) << "us" << std::endl
+                << "    incremental hash:   " << run_workload<utils::DynamicBitset<std::uint64_t, 0, true>>(num_iterations, num_objects, positions, checksum) << "us" << std::endl;
+        }
+    }
+    std::cout << "Checksum: " << checksum << std::endl;
+    return 0;
+}
@@ -0,0 +1,112 @@
+#include <vector>
+#include <iostream>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+
+#include "../include/dlplan/core.h"
+
+using namespace dlplan;
+
+
+/*
+  Benchmark of DenotationsCaches that are saved to a file after a cold
+  run and loaded by a warm run, which recreates the features with another
+  factory as a separate process would.
+
+  The warm run evaluates each feature once per state and finds all of
+  them in the file, i.e., it computes no denotation.
+*/
+
+template<typename F>
+static long long time_in_microseconds(F&& function) {
+    auto start = std::chrono::steady_clock::now();
+    function();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+}
+
+static std::vector<std::shared_ptr<const core::Numerical>> create_numericals(core::SyntacticElementFactory& factory) {
+    std::vector<std::shared_ptr<const core::Numerical>> numericals;
+    std::vector<std::string> concepts{"c_primitive(at,0)", "c_primitive(painted,0)", "c_primitive(on,0)", "c_primitive(on,1)", "c_top"};
+    std::vector<std::string> roles{"r_primitive(conn,0,1)", "r_primitive(on,0,1)", "r_inverse(r_primitive(on,0,1))", "r_transitive_closure(r_primitive(on,0,1))"};
+    for (const auto& role : roles) {
+        for (const auto& concept_ : concepts) {
+            numericals.push_back(factory.parse_numerical("n_count(c_some(" + role + "," + concept_ + "))"));
+            numericals.push_back(factory.parse_numerical("n_count(c_all(" + role + "," + concept_ + "))"));
+        }
+    }
+    return numericals;
+}
+
+int main(int argc, char** argv) {
+    if (argc != 4) {
+        std::cout << "User error. Expected: ./experiment_persistent_caches <int:num_states> <int:num_objects> <string:filename>" << std::endl;
+        return 1;
+    }
+    int num_states = std::atoi(argv[1]);
+    int num_objects = std::atoi(argv[2]);
+    std::string filename = argv[3];
+    auto vocabulary = std::make_shared<core::VocabularyInfo>();
+    vocabulary->add_predicate("conn", 2, true);
+    vocabulary->add_predicate("at", 1);
+    vocabulary->add_predicate("painted", 1);
+    vocabulary->add_predicate("on", 2);
+    auto instance = std::make_shared<core::InstanceInfo>(vocabulary, 0);
+    std::vector<core::Atom> at_atoms, painted_atoms, on_atoms;
+    for (int i = 0; i < num_objects; ++i) {
+        std::string object = "o" + std::to_string(i);
+        std::string next_object = "o" + std::to_string(i + 1);
+        at_atoms.push_back(instance->add_atom("at", {object}));
+        painted_atoms.push_back(instance->add_atom("painted", {object}));
+        if (i + 1 < num_objects) {
+            instance->add_static_atom("conn", {object, next_object});
+            on_atoms.push_back(instance->add_atom("on", {object, next_object}));
+        }
+    }
+    std::mt19937 generator(0);
+    std::vector<core::State> states;
+    for (int i = 0; i < num_states; ++i) {
+        std::vector<core::Atom> atoms;
+        for (const auto& atom : at_atoms) if (generator() % 5 == 0) atoms.push_back(atom);
+        for (const auto& atom : painted_atoms) if (generator() % 2 == 0) atoms.push_back(atom);
+        for (const auto& atom : on_atoms) if (generator() % 3 == 0) atoms.push_back(atom);
+        states.emplace_back(instance, atoms, i);
+    }
+
+    // Checksum prevents the compiler from removing the benchmarked code.
+    long long cold_checksum = 0;
+    long long warm_checksum = 0;
+    {
+        core::SyntacticElementFactory factory(vocabulary);
+        auto numericals = create_numericals(factory);
+        core::DenotationsCaches caches;
+        std::cout << "num_states=" << num_states << " num_objects=" << num_objects
+                  << " num_features=" << numericals.size() << std::endl;
+        std::cout << "Time cold evaluation: " << time_in_microseconds([&](){
+            for (const auto& state : states) {
+                for (const auto& numerical : numericals) cold_checksum += numerical->evaluate(state, caches);
+            }
+        }) << "us" << std::endl;
+        std::cout << "Time save: " << time_in_microseconds([&](){
+            caches.save(filename, std::vector<std::shared_ptr<const core::BaseElement>>(numericals.begin(), numericals.end()), states);
+        }) << "us" << std::endl;
+    }
+    {
+        core::SyntacticElementFactory factory(vocabulary);
+        auto numericals = create_numericals(factory);
+        core::DenotationsCaches caches;
+        std::cout << "Time load: " << time_in_microseconds([&](){
+            caches.load(filename);
+        }) << "us" << std::endl;
+        std::cout << "Time warm evaluation: " << time_in_microseconds([&](){
+            for (const auto& state : states) {
+                for (const auto& numerical : numericals) warm_checksum += numerical->evaluate(state, caches);
+            }
+        }) << "us" << std::endl;
+    }
+    std::remove(filename.c_str());
+    std::cout << "Checksum: " << cold_checksum << " " << warm_checksum << std::endl;
+    return cold_checksum == warm_checksum ? 0 : 1;
+}
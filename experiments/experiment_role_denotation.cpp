@@ -0,0 +1,146 @@
+#include <vector>
+#include <iostream>
+#include <chrono>
+#include <random>
+
+#include "../include/dlplan/core.h"
+#include "../include/dlplan/state_space.h"
+#include "../src/utils/system.h"
+
+using namespace dlplan;
+
+
+/*
+  Benchmark for the sparse/dense adaptive representation of RoleDenotation.
+
+  The synthetic part compares memory and runtime of role denotations over
+  500 objects with increasing number of pairs against the size of the dense
+  bit matrix, and the composition with insert_composition against one
+  insert_successors per pair of the left role. The optional instance part evaluates all primitive roles and
+  their pairwise compositions on every state of a state space and reports
+  memory usage of the cached role denotations and peak memory.
+*/
+
+template<typename F>
+static long long time_in_microseconds(int num_iterations, F&& function) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < num_iterations; ++i) {
+        function();
+    }
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+}
+
+static void run_synthetic(int num_iterations) {
+    const int num_objects = 500;
+    std::mt19937 generator(0);
+    std::uniform_int_distribution<int> distribution(0, num_objects - 1);
+    // Checksum prevents the compiler from removing the benchmarked code.
+    long long checksum = 0;
+    std::cout << "Dense bit matrix: " << num_objects * ((num_objects + 63) / 64) * 8 << " bytes" << std::endl;
+    for (int num_pairs : {10, 50, 500, 5000, 50000}) {
+        core::PairsOfObjectIndices pairs;
+        for (int i = 0; i < num_pairs; ++i) {
+            pairs.emplace_back(distribution(generator), distribution(generator));
+        }
+        core::RoleDenotation left(num_objects);
+        core::RoleDenotation right(num_objects);
+        core::ConceptDenotation concept(num_objects);
+        for (const auto& pair : pairs) {
+            left.insert(pair);
+            right.insert(std::make_pair(pair.second, pair.first));
+            concept.insert(pair.first);
+        }
+        std::cout << "num_objects=" << num_objects << " num_pairs=" << left.size()
+            << " dense=" << left.is_dense() << " memory=" << left.compute_memory_usage() << " bytes" << std::endl
+            << "    insert:               " << time_in_microseconds(num_iterations, [&](){
+                    core::RoleDenotation denotation(num_objects);
+                    for (const auto& pair : pairs) denotation.insert(pair);
+                    checksum += denotation.size(); }) << "us" << std::endl
+            << "    contains:             " << time_in_microseconds(num_iterations, [&](){
+                    for (const auto& pair : pairs) checksum += right.contains(pair); }) << "us" << std::endl
+            << "    union, intersection:  " << time_in_microseconds(num_iterations, [&](){
+                    core::RoleDenotation denotation = left;
+                    denotation |= right;
+                    denotation &= left;
+                    checksum += denotation.size(); }) << "us" << std::endl
+            << "    hash:                 " << time_in_microseconds(num_iterations, [&](){ checksum += left.hash(); }) << "us" << std::endl
+            << "    successors_intersect: " << time_in_microseconds(num_iterations, [&](){
+                    for (int i = 0; i < num_objects; ++i) checksum += left.successors_intersect(i, concept); }) << "us" << std::endl
+            << "    compose per pair:     " << time_in_microseconds(num_iterations, [&](){
+                    core::RoleDenotation denotation(num_objects);
+                    for (const auto pair : left) denotation.insert_successors(pair.first, right, pair.second);
+                    checksum += denotation.size(); }) << "us" << std::endl
+            << "    compose:              " << time_in_microseconds(num_iterations, [&](){
+                    core::RoleDenotation denotation(num_objects);
+                    denotation.insert_composition(left, right);
+                    checksum += denotation.size(); }) << "us" << std::endl;
+    }
+    std::cout << "Checksum: " << checksum << std::endl;
+}
+
+static void run_instance(const std::string& domain_filename, const std::string& instance_filename, int num_iterations) {
+    auto result = state_space::generate_state_space(domain_filename, instance_filename, nullptr, 0);
+    auto state_space = result.state_space;
+    auto instance_info = state_space.get_instance_info();
+    int num_objects = instance_info->get_objects().size();
+    std::cout << "Number of states: " << state_space.get_states().size() << std::endl;
+    std::cout << "Number of objects: " << num_objects << std::endl;
+
+    auto factory = core::SyntacticElementFactory(instance_info->get_vocabulary_info());
+    std::vector<std::shared_ptr<const core::Role>> primitive_roles;
+    for (const auto& predicate : instance_info->get_vocabulary_info()->get_predicates()) {
+        for (int pos_1 = 0; pos_1 < predicate.get_arity(); ++pos_1) {
+            for (int pos_2 = pos_1 + 1; pos_2 < predicate.get_arity(); ++pos_2) {
+                primitive_roles.push_back(factory.make_primitive_role(predicate, pos_1, pos_2));
+            }
+        }
+    }
+    std::vector<std::shared_ptr<const core::Role>> roles = primitive_roles;
+    for (const auto& left : primitive_roles) {
+        for (const auto& right : primitive_roles) {
+            roles.push_back(factory.make_compose_role(left, right));
+        }
+    }
+    std::cout << "Number of roles: " << roles.size() << std::endl;
+
+    core::DenotationsCaches caches;
+    long long num_denotations = 0;
+    long long num_dense = 0;
+    long long memory_usage = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < num_iterations; ++i) {
+        for (const auto& pair : state_space.get_states()) {
+            for (const auto& role : roles) {
+                const auto* denotation = role->evaluate(pair.second, caches);
+                if (i == 0) {
+                    ++num_denotations;
+                    num_dense += denotation->is_dense();
+                    memory_usage += denotation->compute_memory_usage();
+                }
+            }
+        }
+    }
+    auto end = std::chrono::steady_clock::now();
+    std::cout << "Time evaluate roles with cache: "
+        << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << "ms" << std::endl;
+    std::cout << "Role denotations: " << num_denotations << " (" << num_dense << " dense)" << std::endl;
+    std::cout << "Memory of role denotations summed over states: " << memory_usage << " bytes" << std::endl;
+    std::cout << "Memory of role denotations as dense bit matrices: "
+        << num_denotations * num_objects * ((num_objects + 63) / 64) * 8 << " bytes" << std::endl;
+    std::cout << "Peak memory: " << utils::get_peak_memory_in_kb() << " KB" << std::endl;
+}
+
+
+int main(int argc, char** argv) {
+    if (argc != 2 && argc != 4) {
+        std::cout << "User error. Expected: ./experiment_role_denotation <int:num_iterations> or ./experiment_role_denotation <str:domain_filename> <str:instance_filename> <int:num_iterations>" << std::endl;
+        return 1;
+    }
+    if (argc == 2) {
+        run_synthetic(std::atoi(argv[1]));
+    } else {
+        run_instance(argv[1], argv[2], std::atoi(argv[3]));
+    }
+    return 0;
+}
@@ -0,0 +1,125 @@
+#include <vector>
+#include <iostream>
+#include <chrono>
+#include <random>
+#include <string>
+
+#include "../include/dlplan/core.h"
+
+using namespace dlplan;
+
+
+/*
+  Benchmark of RoleDenotation::transitive_closure, i.e., word-parallel row
+  operations over the condensation into strongly connected components,
+  against the fixpoint iteration
+  over all pairs that r_transitive_closure used before. The fixpoint
+  iteration only runs up to 200 objects.
+
+  Graphs are random with n and 8n edges, and graphs that resemble roles of
+  planning domains: a tower of blocks (a path), a road network (a
+  bidirectional grid), a tree of locations, and a dense partial order.
+*/
+
+template<typename F>
+static long long time_in_microseconds(int num_iterations, F&& function) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < num_iterations; ++i) {
+        function();
+    }
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+}
+
+static core::RoleDenotation compute_fixpoint(const core::RoleDenotation& denot) {
+    core::RoleDenotation result = denot;
+    bool changed = false;
+    do {
+        core::RoleDenotation tmp_result = result;
+        int num_objects = tmp_result.get_num_objects();
+        for (const auto pair_1 : tmp_result) {
+            for (int target = 0; target < num_objects; ++target) {
+                if (tmp_result.contains(std::make_pair(pair_1.second, target))) {
+                    result.insert(std::make_pair(pair_1.first, target));
+                }
+            }
+        }
+        changed = (result.size() != tmp_result.size());
+    } while (changed);
+    return result;
+}
+
+static core::RoleDenotation make_graph(const std::string& name, int num_objects, std::mt19937& generator) {
+    core::RoleDenotation result(num_objects);
+    std::uniform_int_distribution<int> distribution(0, num_objects - 1);
+    if (name == "random-n" || name == "random-8n") {
+        int num_edges = (name == "random-n") ? num_objects : 8 * num_objects;
+        for (int i = 0; i < num_edges; ++i) {
+            result.insert(std::make_pair(distribution(generator), distribution(generator)));
+        }
+    } else if (name == "tower") {
+        for (int i = 0; i + 1 < num_objects; ++i) {
+            result.insert(std::make_pair(i, i + 1));
+        }
+    } else if (name == "grid") {
+        int width = 1;
+        while (width * width < num_objects) ++width;
+        for (int i = 0; i < num_objects; ++i) {
+            if ((i + 1) % width != 0 && i + 1 < num_objects) {
+                result.insert(std::make_pair(i, i + 1));
+                result.insert(std::make_pair(i + 1, i));
+            }
+            if (i + width < num_objects) {
+                result.insert(std::make_pair(i, i + width));
+                result.insert(std::make_pair(i + width, i));
+            }
+        }
+    } else if (name == "order") {
+        std::bernoulli_distribution coin(0.5);
+        for (int i = 0; i < num_objects; ++i) {
+            for (int j = i + 1; j < num_objects; ++j) {
+                if (coin(generator)) result.insert(std::make_pair(i, j));
+            }
+        }
+    } else if (name == "tree") {
+        for (int i = 1; i < num_objects; ++i) {
+            result.insert(std::make_pair((i - 1) / 2, i));
+        }
+    }
+    return result;
+}
+
+int main(int argc, char** argv) {
+    if (argc != 2) {
+        std::cout << "User error. Expected: ./experiment_transitive_closure <int:num_iterations>" << std::endl;
+        return 1;
+    }
+    int num_iterations = std::atoi(argv[1]);
+    std::mt19937 generator(0);
+    // Checksum prevents the compiler from removing the benchmarked code.
+    long long checksum = 0;
+    for (const std::string name : {"random-n", "random-8n", "tower", "grid", "tree", "order"}) {
+        for (int num_objects : {50, 100, 200, 500, 1000}) {
+            core::RoleDenotation graph = make_graph(name, num_objects, generator);
+            core::RoleDenotation closure = graph;
+            closure.transitive_closure();
+            std::cout << name << " num_objects=" << num_objects
+                << " num_pairs=" << graph.size() << " (dense=" << graph.is_dense() << ")"
+                << " closure_size=" << closure.size() << std::endl
+                << "    closure:  " << time_in_microseconds(num_iterations, [&](){
+                        core::RoleDenotation result = graph;
+                        result.transitive_closure();
+                        checksum += result.size(); }) << "us" << std::endl;
+            if (num_objects <= 200) {
+                if (compute_fixpoint(graph) != closure) {
+                    std::cout << "Error: closures differ." << std::endl;
+                    return 1;
+                }
+                std::cout << "    fixpoint: " << time_in_microseconds(num_iterations, [&](){
+                        checksum += compute_fixpoint(graph).size(); }) << "us" << std::endl;
+            }
+        }
+    }
+    std::cout << "Checksum: " << checksum << std::endl;
+    return 0;
+}
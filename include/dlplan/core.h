@@ -6,10 +6,20 @@
 
 #include "phmap/phmap.h"
 #include "utils/pimpl.h"
+#include "utils/arena.h"
 #include "utils/dynamic_bitset.h"
 
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <shared_mutex>
 #include <string>
+#include <type_traits>
 #include <unordered_set>
 #include <unordered_map>
 #include <vector>
@@ -23,6 +33,14 @@ class VocabularyInfo;
 class State;
 class ConceptDenotation;
 class RoleDenotation;
+class ConceptDenotationMatrix;
+class RoleDenotationMatrix;
+class BaseElement;
+class Concept;
+class DenotationsFile;
+class Role;
+class EvaluationOperands;
+class EvaluationProgram;
 
 using ConceptDenotations = std::vector<const ConceptDenotation*>;
 using RoleDenotations = std::vector<const RoleDenotation*>;
@@ -113,10 +131,63 @@ struct hash_impl<std::vector<int>> {
 /// object of a common instance info.
 class ConceptDenotation {
 private:
+    // Instances with up to 256 objects are stored inline without heap allocation.
+    static constexpr std::size_t NUM_INLINE_BLOCKS = 4;
+    using Bitset = dlplan::utils::DynamicBitset<std::uint64_t, NUM_INLINE_BLOCKS>;
+
     int m_num_objects;
-    dlplan::utils::DynamicBitset<unsigned> m_data;
+    // Hash value that is computed on first use and reset by every modification.
+    mutable bool m_has_hash;
+    mutable std::size_t m_hash;
+    Bitset m_data;
+
+    void invalidate_hash();
+
+    friend class RoleDenotation;
+    friend class ConceptDenotationMatrix;
 
 public:
+    /// @brief Forward iterator over the object indices in ascending order.
+    ///        Iterating does not allocate memory.
+    class const_iterator {
+    private:
+        const Bitset* m_data;
+        std::size_t m_pos;
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = ObjectIndex;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const ObjectIndex*;
+        using reference = ObjectIndex;
+
+        const_iterator(const Bitset& data, std::size_t pos)
+            : m_data(&data), m_pos(pos) { }
+
+        ObjectIndex operator*() const {
+            return static_cast<ObjectIndex>(m_pos);
+        }
+
+        const_iterator& operator++() {
+            m_pos = m_data->find_next(m_pos);
+            return *this;
+        }
+
+        const_iterator operator++(int) {
+            const_iterator prev = *this;
+            ++(*this);
+            return prev;
+        }
+
+        bool operator==(const const_iterator& other) const {
+            return m_pos == other.m_pos;
+        }
+
+        bool operator!=(const const_iterator& other) const {
+            return !(*this == other);
+        }
+    };
+
     explicit ConceptDenotation(int num_objects);
     ConceptDenotation(const ConceptDenotation& other);
     ConceptDenotation& operator=(const ConceptDenotation& other);
@@ -134,14 +205,21 @@ public:
 
     bool contains(ObjectIndex value) const;
     void set();
+    /// @brief Removes all objects without releasing memory.
+    void clear();
     void insert(ObjectIndex value);
     void erase(ObjectIndex value);
 
     int size() const;
     bool empty() const;
     bool intersects(const ConceptDenotation& other) const;
+    /// @brief Returns the size of the intersection without computing it.
+    int intersection_size(const ConceptDenotation& other) const;
     bool is_subset_of(const ConceptDenotation& other) const;
 
+    /// @brief Compute the number of bytes of heap memory used to store the objects.
+    std::size_t compute_memory_usage() const;
+
     /// @brief Compute the canonical string representation of this concept denotation.
     /// @return The canonical string representation of this concept denotation.
     std::string compute_repr() const;
@@ -165,6 +243,24 @@ public:
     /// @return A vector of object indices in ascending order.
     ObjectIndices to_sorted_vector() const;
 
+    const_iterator begin() const {
+        return const_iterator(m_data, m_data.find_first());
+    }
+
+    const_iterator end() const {
+        return const_iterator(m_data, m_data.npos);
+    }
+
+    /// @brief Calls the function on every object index in ascending order
+    ///        without materializing a vector.
+    /// @param function Callable that accepts an ObjectIndex.
+    template<typename Function>
+    void for_each(Function&& function) const {
+        for (auto pos = m_data.find_first(); pos != m_data.npos; pos = m_data.find_next(pos)) {
+            function(static_cast<ObjectIndex>(pos));
+        }
+    }
+
     std::size_t hash() const;
     int get_num_objects() const;
 };
@@ -177,12 +273,104 @@ public:
 /// The set of pairs of object indices represent the elements in the binary
 /// relation of the role that are true in a given state. Each object index
 /// refers to an object of a common instance info.
+///
+/// Sparse role denotations are stored as a sorted vector of pairs. Dense
+/// role denotations are stored as a row-major bit matrix. Each row holds the
+/// successors of one source object and is padded to whole blocks, such that
+/// a row has the same layout as a ConceptDenotation over the same objects.
+/// This allows word-parallel operations between rows and concepts.
+/// The representation is determined by the number of pairs only. Hence,
+/// equal role denotations always have equal representations.
 class RoleDenotation {
 private:
     int m_num_objects;
-    dlplan::utils::DynamicBitset<unsigned> m_data;
+    // Number of bits per row, a multiple of the block size.
+    int m_row_size;
+    // Number of pairs.
+    int m_size;
+    bool m_is_dense;
+    // Sorted pairs in the sparse representation, empty otherwise.
+    PairsOfObjectIndices m_pairs;
+    // Bit matrix in the dense representation, empty otherwise.
+    dlplan::utils::DynamicBitset<std::uint64_t> m_data;
+    // Lazily computed hash value and transposed matrix for predecessor queries.
+    // They are computed on first use and reset by every modification.
+    mutable bool m_has_hash;
+    mutable std::size_t m_hash;
+    mutable std::shared_ptr<const dlplan::utils::DynamicBitset<std::uint64_t>> m_transpose;
+
+    std::size_t compute_position(ObjectIndex source, ObjectIndex target) const;
+    std::size_t get_num_blocks_per_row() const;
+    const std::uint64_t* get_row(ObjectIndex source) const;
+    PairsOfObjectIndices::const_iterator get_row_begin(ObjectIndex source) const;
+    PairsOfObjectIndices::const_iterator get_row_end(ObjectIndex source) const;
+    ObjectIndices get_sorted_successors(ObjectIndex source) const;
+    const dlplan::utils::DynamicBitset<std::uint64_t>& get_transpose() const;
+    void insert_pairs(ObjectIndex source, const ObjectIndices& targets);
+    void zero_padding_bits();
+    void invalidate_caches();
+    int get_max_sparse_size() const;
+    void convert_to_dense();
+    void convert_to_sparse();
+    void update_representation();
+
+    friend class RoleDenotationMatrix;
 
 public:
+    /// @brief Forward iterator over the pairs of object indices in ascending
+    ///        order by first then second element. Iterating does not allocate memory.
+    class const_iterator {
+    private:
+        // Exactly one of m_data and m_pair is used, depending on the representation.
+        const dlplan::utils::DynamicBitset<std::uint64_t>* m_data;
+        const PairOfObjectIndices* m_pair;
+        std::size_t m_pos;
+        int m_row_size;
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = PairOfObjectIndices;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const PairOfObjectIndices*;
+        using reference = PairOfObjectIndices;
+
+        const_iterator(const dlplan::utils::DynamicBitset<std::uint64_t>& data, std::size_t pos, int row_size)
+            : m_data(&data), m_pair(nullptr), m_pos(pos), m_row_size(row_size) { }
+
+        explicit const_iterator(const PairOfObjectIndices* pair)
+            : m_data(nullptr), m_pair(pair), m_pos(0), m_row_size(0) { }
+
+        PairOfObjectIndices operator*() const {
+            if (m_pair) {
+                return *m_pair;
+            }
+            return PairOfObjectIndices(m_pos / m_row_size, m_pos % m_row_size);
+        }
+
+        const_iterator& operator++() {
+            if (m_pair) {
+                ++m_pair;
+            } else {
+                m_pos = m_data->find_next(m_pos);
+            }
+            return *this;
+        }
+
+        const_iterator operator++(int) {
+            const_iterator prev = *this;
+            ++(*this);
+            return prev;
+        }
+
+        bool operator==(const const_iterator& other) const {
+            return m_pos == other.m_pos && m_pair == other.m_pair;
+        }
+
+        bool operator!=(const const_iterator& other) const {
+            return !(*this == other);
+        }
+    };
+
     explicit RoleDenotation(int num_objects);
     RoleDenotation(const RoleDenotation& other);
     RoleDenotation& operator=(const RoleDenotation& other);
@@ -200,6 +388,8 @@ public:
 
     bool contains(const PairOfObjectIndices& value) const;
     void set();
+    /// @brief Removes all pairs. The sparse representation keeps its memory.
+    void clear();
     void insert(const PairOfObjectIndices& value);
     void erase(const PairOfObjectIndices& value);
 
@@ -231,14 +421,233 @@ public:
     /// @return A vector of pairs of object indices in ascending order by first then second element.
     PairsOfObjectIndices to_sorted_vector() const;
 
+    const_iterator begin() const {
+        if (!m_is_dense) {
+            return const_iterator(m_pairs.data());
+        }
+        return const_iterator(m_data, m_data.find_first(), m_row_size);
+    }
+
+    const_iterator end() const {
+        if (!m_is_dense) {
+            return const_iterator(m_pairs.data() + m_pairs.size());
+        }
+        return const_iterator(m_data, m_data.npos, m_row_size);
+    }
+
+    /// @brief Calls the function on every pair of object indices in ascending
+    ///        order by first then second element without materializing a vector.
+    /// @param function Callable that accepts an ObjectIndex as source and an ObjectIndex as target.
+    template<typename Function>
+    void for_each(Function&& function) const {
+        if (!m_is_dense) {
+            for (const auto& pair : m_pairs) {
+                function(pair.first, pair.second);
+            }
+            return;
+        }
+        for (auto pos = m_data.find_first(); pos != m_data.npos; pos = m_data.find_next(pos)) {
+            function(static_cast<ObjectIndex>(pos / m_row_size), static_cast<ObjectIndex>(pos % m_row_size));
+        }
+    }
+
+    /// @brief Compute the set of objects b such that (source,b) is in this role denotation.
+    /// @param source The index of the source object.
+    /// @return The successors of the source as a concept denotation.
+    ConceptDenotation get_successors(ObjectIndex source) const;
+
+    /// @brief Compute the set of objects b such that (a,b) is in this role denotation
+    ///        for some a in the sources. Dense rows of the sources are combined word-parallel.
+    /// @param sources The source objects.
+    /// @return The successors of the sources as a concept denotation.
+    ConceptDenotation get_successors(const ConceptDenotation& sources) const;
+
+    /// @brief Compute the set of objects a such that (a,target) is in this role denotation.
+    ///        The first call computes and stores the transposed matrix.
+    /// @param target The index of the target object.
+    /// @return The predecessors of the target as a concept denotation.
+    ConceptDenotation get_predecessors(ObjectIndex target) const;
+
+    /// @brief Compute the set of objects a such that (a,b) is in this role denotation
+    ///        for some b in the targets.
+    /// @param targets The target objects.
+    /// @return The predecessors of the targets as a concept denotation.
+    ConceptDenotation get_predecessors(const ConceptDenotation& targets) const;
+
+    /// @brief Checks whether the source has any successor.
+    bool has_successors(ObjectIndex source) const;
+
+    /// @brief Checks whether some successor of the source is in the concept denotation.
+    bool successors_intersect(ObjectIndex source, const ConceptDenotation& targets) const;
+
+    /// @brief Checks whether all successors of the source are in the concept denotation.
+    bool successors_are_subset_of(ObjectIndex source, const ConceptDenotation& targets) const;
+
+    /// @brief Adds (source,b) for every b in the concept denotation.
+    void insert_successors(ObjectIndex source, const ConceptDenotation& targets);
+
+    /// @brief Adds (source,b) for every b such that (other_source,b) is in the other role denotation.
+    ///        This is the row operation of a boolean matrix product.
+    void insert_successors(ObjectIndex source, const RoleDenotation& other, ObjectIndex other_source);
+
+    /// @brief Adds (a,c) for every (a,b) in the left and (b,c) in the right role denotation,
+    ///        i.e., the boolean matrix product. Collects pairs if the product is small
+    ///        and adds rows of the right operand to a bit matrix otherwise.
+    void insert_composition(const RoleDenotation& left, const RoleDenotation& right);
+
+    /// @brief Removes (source,b) for every b that is not in the concept denotation.
+    void restrict_successors(ObjectIndex source, const ConceptDenotation& targets);
+
+    /// @brief Replaces the pairs by their transitive closure. Rows are computed
+    ///        in reverse topological order of the strongly connected components.
+    void transitive_closure();
+
+    /// @brief Checks whether the pairs are stored as a bit matrix instead of a sorted vector.
+    bool is_dense() const;
+
+    /// @brief Compute the number of bytes of heap memory used to store the pairs.
+    std::size_t compute_memory_usage() const;
+
     std::size_t hash() const;
     int get_num_objects() const;
 };
 
 
+/// @brief Encapsulates the results of the evaluation of a concept on a
+///        sequence of states as a single bit matrix with one row per state.
+///
+/// All rows have the same number of blocks, such that set operations over
+/// all states are single loops over contiguous memory and the matrix is
+/// hashed at once. The row of a state of an instance with fewer objects than
+/// the largest instance is padded with zeros.
+class ConceptDenotationMatrix {
+private:
+    using Bitset = dlplan::utils::DynamicBitset<std::uint64_t>;
+
+    std::vector<int> m_num_objects;
+    int m_num_blocks_per_row;
+    Bitset m_data;
+
+    std::size_t compute_position(int row, ObjectIndex value) const;
+    void zero_padding_bits();
+
+public:
+    /// @brief Creates a matrix without elements.
+    /// @param num_objects The number of objects of each row.
+    explicit ConceptDenotationMatrix(const std::vector<int>& num_objects);
+    /// @brief Creates a matrix with one row per concept denotation.
+    explicit ConceptDenotationMatrix(const ConceptDenotations& denotations);
+    ConceptDenotationMatrix(const ConceptDenotationMatrix& other);
+    ConceptDenotationMatrix& operator=(const ConceptDenotationMatrix& other);
+    ConceptDenotationMatrix(ConceptDenotationMatrix&& other);
+    ConceptDenotationMatrix& operator=(ConceptDenotationMatrix&& other);
+    ~ConceptDenotationMatrix();
+
+    bool operator==(const ConceptDenotationMatrix& other) const;
+    bool operator!=(const ConceptDenotationMatrix& other) const;
+
+    /// @brief Rowwise set operations on matrices with the same number of objects per row.
+    ConceptDenotationMatrix& operator&=(const ConceptDenotationMatrix& other);
+    ConceptDenotationMatrix& operator|=(const ConceptDenotationMatrix& other);
+    ConceptDenotationMatrix& operator-=(const ConceptDenotationMatrix& other);
+    ConceptDenotationMatrix& operator~();
+
+    bool contains(int row, ObjectIndex value) const;
+    void insert(int row, ObjectIndex value);
+    void erase(int row, ObjectIndex value);
+    int size(int row) const;
+
+    /// @brief Copies a row into a concept denotation.
+    ConceptDenotation get_denotation(int row) const;
+
+    /// @brief Compute the number of bytes of heap memory used to store the matrix.
+    std::size_t compute_memory_usage() const;
+
+    std::size_t hash() const;
+    int get_num_rows() const;
+    int get_num_objects(int row) const;
+};
+
+
+/// @brief Encapsulates the results of the evaluation of a role on a sequence
+///        of states as a single bit matrix with one row per state.
+///
+/// Each row stores the dense row-major bit matrix of a RoleDenotation over
+/// the largest number of objects, i.e., the rows of all states are aligned.
+class RoleDenotationMatrix {
+private:
+    using Bitset = dlplan::utils::DynamicBitset<std::uint64_t>;
+
+    std::vector<int> m_num_objects;
+    int m_max_num_objects;
+    int m_num_blocks_per_object;
+    Bitset m_data;
+
+    std::size_t get_num_blocks_per_row() const;
+    std::size_t compute_position(int row, const PairOfObjectIndices& value) const;
+    void zero_padding_bits();
+
+public:
+    /// @brief Creates a matrix without elements.
+    /// @param num_objects The number of objects of each row.
+    explicit RoleDenotationMatrix(const std::vector<int>& num_objects);
+    /// @brief Creates a matrix with one row per role denotation.
+    explicit RoleDenotationMatrix(const RoleDenotations& denotations);
+    RoleDenotationMatrix(const RoleDenotationMatrix& other);
+    RoleDenotationMatrix& operator=(const RoleDenotationMatrix& other);
+    RoleDenotationMatrix(RoleDenotationMatrix&& other);
+    RoleDenotationMatrix& operator=(RoleDenotationMatrix&& other);
+    ~RoleDenotationMatrix();
+
+    bool operator==(const RoleDenotationMatrix& other) const;
+    bool operator!=(const RoleDenotationMatrix& other) const;
+
+    /// @brief Rowwise set operations on matrices with the same number of objects per row.
+    RoleDenotationMatrix& operator&=(const RoleDenotationMatrix& other);
+    RoleDenotationMatrix& operator|=(const RoleDenotationMatrix& other);
+    RoleDenotationMatrix& operator-=(const RoleDenotationMatrix& other);
+    RoleDenotationMatrix& operator~();
+
+    bool contains(int row, const PairOfObjectIndices& value) const;
+    void insert(int row, const PairOfObjectIndices& value);
+    void erase(int row, const PairOfObjectIndices& value);
+    int size(int row) const;
+
+    /// @brief Copies a row into a role denotation.
+    RoleDenotation get_denotation(int row) const;
+
+    /// @brief Compute the number of bytes of heap memory used to store the matrix.
+    std::size_t compute_memory_usage() const;
+
+    std::size_t hash() const;
+    int get_num_rows() const;
+    int get_num_objects(int row) const;
+};
+
+
 /// @brief Encapsulates caches for denotations and provides functionality to
 ///        insert and retrieve denotations into and respectively from the cache.
+///
+///        The caches can be bounded by a memory limit. Evaluation evicts
+///        denotations only when it starts outside of any other evaluation
+///        with the same caches. Raw pointers to cached denotations are thus
+///        valid until the next evaluation if a memory limit is set, and
+///        until destruction otherwise.
+///
+///        Default caches must be used by one thread at a time. Concurrent
+///        caches lock shards of each cache and evict only when no thread
+///        is evaluating.
 class DenotationsCaches {
+public:
+    /// @brief Counters of a cache. Bytes are an estimate of the memory
+    ///        used by the denotations and the mapping to them.
+    struct Statistics {
+        std::size_t num_hits = 0;
+        std::size_t num_misses = 0;
+        std::size_t num_evictions = 0;
+        std::size_t num_bytes = 0;
+    };
+
 private:
     struct Key {
         ElementIndex element;
@@ -255,27 +664,214 @@ private:
 
     template<typename T>
     struct Cache {
-        struct UniquePtrHash {
-            std::size_t operator()(const std::unique_ptr<const T>& ptr) const {
+        // Concept and role denotations store their hash value when it is
+        // computed upon insertion, so lookups never rehash cached denotations.
+        struct PtrHash {
+            std::size_t operator()(const T* ptr) const {
                 return dlplan::core::hash<T>()(*ptr);
             }
         };
 
-        struct UniquePtrEqual {
-            bool operator()(const std::unique_ptr<const T>& left, const std::unique_ptr<const T>& right) const {
+        struct PtrEqual {
+            bool operator()(const T* left, const T* right) const {
                 return *left == *right;
             }
         };
 
-        // We use unique_ptr such that other raw pointers do not become invalid.
-        std::unordered_set<std::unique_ptr<const T>, UniquePtrHash, UniquePtrEqual> m_uniqueness;
-        std::unordered_map<Key, const T*, KeyHash> m_per_element_instance_state_mapping;
+        /// @brief Returns the number of bytes of a denotation including its heap memory.
+        static std::size_t compute_num_bytes(const T& denotation) {
+            if constexpr (std::is_same<T, ConceptDenotation>::value || std::is_same<T, RoleDenotation>::value) {
+                return sizeof(T) + denotation.compute_memory_usage();
+            } else if constexpr (std::is_arithmetic<T>::value) {
+                return sizeof(T);
+            } else {
+                return sizeof(T) + denotation.capacity() * sizeof(typename T::value_type);
+            }
+        }
+
+        /// @brief Denotations that are inserted between two evictions and
+        ///        the mapping from element, instance, and state to them.
+        struct Generation {
+            // Unique denotations are stored contiguously and released in bulk
+            // when the generation is destroyed. Raw pointers to them remain valid.
+            dlplan::utils::ObjectArena<T> m_storage;
+            phmap::flat_hash_set<const T*, PtrHash, PtrEqual> m_uniqueness;
+            // Instance, element, and state indices are compact in practice, such
+            // that the mapping is a table indexed by instance + 1, element, and
+            // state + 1, because static and batched denotations have index -1.
+            // Keys that would make the table sparse are stored in a hash table.
+            std::vector<std::vector<std::vector<const T*>>> m_per_instance_element_state_table;
+            phmap::flat_hash_map<Key, const T*, KeyHash> m_per_element_instance_state_mapping;
+            std::size_t m_num_entries = 0;
+            std::size_t m_num_bytes = 0;
+
+            /// @brief Returns true if index is at most twice the size of the table
+            ///        plus a constant, i.e., the table stays dense if it grows.
+            static bool is_compact(int index, std::size_t size) {
+                return index >= 0 && static_cast<std::size_t>(index) <= 2 * size + 64;
+            }
+
+            const T* find_denotation(const T& denotation) const {
+                auto iter = m_uniqueness.find(&denotation);
+                return (iter != m_uniqueness.end()) ? *iter : nullptr;
+            }
+
+            const T* insert_denotation(T&& denotation) {
+                return *m_uniqueness.lazy_emplace(&denotation, [&](const auto& constructor) {
+                    const T* result = m_storage.emplace(std::move(denotation));
+                    m_num_bytes += compute_num_bytes(*result) + sizeof(const T*);
+                    constructor(result);
+                });
+            }
+
+            void insert_denotation(ElementIndex element, InstanceIndex instance, StateIndex state, const T* denotation) {
+                if (get_denotation(element, instance, state)) {
+                    return;
+                }
+                ++m_num_entries;
+                // Table growth is counted by the capacity that the vectors reserve.
+                auto& table = m_per_instance_element_state_table;
+                if (is_compact(instance + 1, table.size())) {
+                    if (static_cast<std::size_t>(instance + 1) >= table.size()) {
+                        std::size_t capacity = table.capacity();
+                        table.resize(instance + 2);
+                        m_num_bytes += (table.capacity() - capacity) * sizeof(std::vector<std::vector<const T*>>);
+                    }
+                    auto& per_element = table[instance + 1];
+                    if (is_compact(element, per_element.size())) {
+                        if (static_cast<std::size_t>(element) >= per_element.size()) {
+                            std::size_t capacity = per_element.capacity();
+                            per_element.resize(element + 1);
+                            m_num_bytes += (per_element.capacity() - capacity) * sizeof(std::vector<const T*>);
+                        }
+                        auto& per_state = per_element[element];
+                        if (is_compact(state + 1, per_state.size())) {
+                            if (static_cast<std::size_t>(state + 1) >= per_state.size()) {
+                                std::size_t capacity = per_state.capacity();
+                                per_state.resize(state + 2, nullptr);
+                                m_num_bytes += (per_state.capacity() - capacity) * sizeof(const T*);
+                            }
+                            per_state[state + 1] = denotation;
+                            return;
+                        }
+                    }
+                }
+                m_num_bytes += sizeof(Key) + sizeof(const T*);
+                m_per_element_instance_state_mapping.emplace(Key{element, instance, state}, denotation);
+            }
+
+            const T* get_denotation(ElementIndex element, InstanceIndex instance, StateIndex state) const {
+                const auto& table = m_per_instance_element_state_table;
+                if (instance + 1 >= 0 && static_cast<std::size_t>(instance + 1) < table.size()) {
+                    const auto& per_element = table[instance + 1];
+                    if (element >= 0 && static_cast<std::size_t>(element) < per_element.size()) {
+                        const auto& per_state = per_element[element];
+                        if (state + 1 >= 0 && static_cast<std::size_t>(state + 1) < per_state.size() && per_state[state + 1]) {
+                            return per_state[state + 1];
+                        }
+                    }
+                }
+                // The key can be in the hash table if it was not compact upon insertion.
+                if (m_per_element_instance_state_mapping.empty()) {
+                    return nullptr;
+                }
+                auto iter = m_per_element_instance_state_mapping.find(Key{element, instance, state});
+                if (iter != m_per_element_instance_state_mapping.end()) {
+                    return iter->second;
+                }
+                return nullptr;
+            }
+        };
+
+        /// @brief Holds the unique denotations whose hash value and the
+        ///        mappings whose element index map to it. Threads that
+        ///        insert different denotations or evaluate different
+        ///        elements rarely lock the same shard.
+        struct Shard {
+            // Eviction discards the previous generation and the current one
+            // becomes the previous one. A hit in the previous generation copies
+            // the denotation into the current one, such that denotations that
+            // are used in each generation survive all evictions.
+            Generation m_current;
+            Generation m_previous;
+            // Open state scopes by instance and state index, i.e., element -1.
+            // Denotations of a scoped state that are not in the current
+            // generation are inserted into the scope and released with it.
+            phmap::flat_hash_map<Key, Generation, KeyHash> m_scopes;
+            Statistics m_statistics;
+            // Null if the caches are not concurrent.
+            std::unique_ptr<std::mutex> m_mutex;
+
+            std::unique_lock<std::mutex> lock() const {
+                return m_mutex ? std::unique_lock<std::mutex>(*m_mutex) : std::unique_lock<std::mutex>();
+            }
+
+            Generation* get_scope(InstanceIndex instance, StateIndex state) {
+                if (m_scopes.empty()) {
+                    return nullptr;
+                }
+                auto iter = m_scopes.find(Key{-1, instance, state});
+                return (iter != m_scopes.end()) ? &iter->second : nullptr;
+            }
+        };
+
+        // The number of shards is a power of two.
+        std::vector<Shard> m_shards;
+        // Bytes of all shards, which concurrent caches maintain because
+        // summing up the shards would require to lock each of them.
+        std::unique_ptr<std::atomic<std::size_t>> m_num_bytes;
+
+        Cache() : m_shards(1) { }
+
+        explicit Cache(int num_shards)
+            : m_shards(num_shards), m_num_bytes(std::make_unique<std::atomic<std::size_t>>(0)) {
+            for (auto& shard : m_shards) {
+                shard.m_mutex = std::make_unique<std::mutex>();
+            }
+        }
+
+        bool is_concurrent() const {
+            return m_num_bytes != nullptr;
+        }
+
+        Shard& get_element_shard(ElementIndex element) {
+            return m_shards[static_cast<std::size_t>(element) & (m_shards.size() - 1)];
+        }
+
+        Shard& get_denotation_shard(const T& denotation) {
+            if (m_shards.size() == 1) {
+                return m_shards[0];
+            }
+            // Multiplicative hashing spreads hash values with few distinct low bits.
+            std::size_t key = (dlplan::core::hash<T>()(denotation) * 0x9E3779B97F4A7C15ull) >> 32;
+            return m_shards[key & (m_shards.size() - 1)];
+        }
+
+        void add_num_bytes(std::size_t num_bytes) {
+            if (m_num_bytes) m_num_bytes->fetch_add(num_bytes, std::memory_order_relaxed);
+        }
+
+        void subtract_num_bytes(std::size_t num_bytes) {
+            if (m_num_bytes) m_num_bytes->fetch_sub(num_bytes, std::memory_order_relaxed);
+        }
+
+        /// @brief Inserts denotation uniquely into the given generation of the shard,
+        ///        which must be locked, and returns its raw pointer.
+        const T* insert_denotation_into(Generation& generation, T&& denotation) {
+            std::size_t num_bytes = generation.m_num_bytes;
+            const T* result = generation.insert_denotation(std::move(denotation));
+            add_num_bytes(generation.m_num_bytes - num_bytes);
+            return result;
+        }
 
         /// @brief Inserts denotation uniquely and returns it raw pointer.
+        ///        The denotation is only moved into the storage if it is new.
         /// @param denotation
         /// @return
         const T* insert_denotation(T&& denotation) {
-            return m_uniqueness.insert(std::unique_ptr<T>(new T(std::move(denotation)))).first->get();
+            Shard& shard = get_denotation_shard(denotation);
+            auto lock = shard.lock();
+            return insert_denotation_into(shard.m_current, std::move(denotation));
         }
 
         /// @brief Inserts raw pointer of denotation into mapping from element, instance, and state.
@@ -284,18 +880,220 @@ private:
         /// @param state_index
         /// @param denotation
         void insert_denotation(ElementIndex element, InstanceIndex instance, StateIndex state, const T* denotation) {
-            Key key{element, instance, state};
-            m_per_element_instance_state_mapping.emplace(key, denotation);
+            Shard& shard = get_element_shard(element);
+            auto lock = shard.lock();
+            Generation* scope = shard.get_scope(instance, state);
+            Generation& generation = scope ? *scope : shard.m_current;
+            std::size_t num_bytes = generation.m_num_bytes;
+            generation.insert_denotation(element, instance, state, denotation);
+            add_num_bytes(generation.m_num_bytes - num_bytes);
+        }
+
+        /// @brief Inserts denotation uniquely, maps element, instance, and state
+        ///        to it, and returns its raw pointer. If a scope is open for
+        ///        the state, a new denotation is released with the scope.
+        const T* insert_denotation(ElementIndex element, InstanceIndex instance, StateIndex state, T&& denotation) {
+            const T* result;
+            {
+                Shard& shard = get_denotation_shard(denotation);
+                auto lock = shard.lock();
+                Generation* scope = shard.get_scope(instance, state);
+                result = scope ? shard.m_current.find_denotation(denotation) : nullptr;
+                if (!result) {
+                    result = insert_denotation_into(scope ? *scope : shard.m_current, std::move(denotation));
+                }
+            }
+            insert_denotation(element, instance, state, result);
+            return result;
+        }
+
+        /// @brief Returns the denotation without counting or promoting it.
+        const T* find_denotation(ElementIndex element, InstanceIndex instance, StateIndex state) const {
+            const Shard& shard = m_shards[static_cast<std::size_t>(element) & (m_shards.size() - 1)];
+            auto lock = shard.lock();
+            auto iter = shard.m_scopes.find(Key{-1, instance, state});
+            const T* denotation = (iter != shard.m_scopes.end()) ? iter->second.get_denotation(element, instance, state) : nullptr;
+            if (!denotation) {
+                denotation = shard.m_current.get_denotation(element, instance, state);
+            }
+            return denotation ? denotation : shard.m_previous.get_denotation(element, instance, state);
+        }
+
+        const T* get_denotation(ElementIndex element, InstanceIndex instance, StateIndex state) {
+            Shard& shard = get_element_shard(element);
+            const T* previous = nullptr;
+            {
+                auto lock = shard.lock();
+                Generation* scope = shard.get_scope(instance, state);
+                const T* denotation = scope ? scope->get_denotation(element, instance, state) : nullptr;
+                if (!denotation) {
+                    denotation = shard.m_current.get_denotation(element, instance, state);
+                }
+                if (!denotation && shard.m_previous.m_num_entries > 0) {
+                    previous = shard.m_previous.get_denotation(element, instance, state);
+                }
+                ++((denotation || previous) ? shard.m_statistics.num_hits : shard.m_statistics.num_misses);
+                if (!previous) {
+                    return denotation;
+                }
+            }
+            // The copy can belong to this shard, so the lock is released first.
+            // The previous generation is not evicted while an evaluation is in progress.
+            return insert_denotation(element, instance, state, T(*previous));
+        }
+
+        /// @brief Opens a scope for the state in all shards.
+        void open_scope(InstanceIndex instance, StateIndex state) {
+            for (auto& shard : m_shards) {
+                auto lock = shard.lock();
+                shard.m_scopes.try_emplace(Key{-1, instance, state});
+            }
+        }
+
+        /// @brief Releases the denotations and mappings of the scope in bulk.
+        ///        The function is called on each denotation that is released.
+        template<typename Function>
+        void close_scope(InstanceIndex instance, StateIndex state, Function&& function) {
+            for (auto& shard : m_shards) {
+                auto lock = shard.lock();
+                auto iter = shard.m_scopes.find(Key{-1, instance, state});
+                if (iter == shard.m_scopes.end()) {
+                    continue;
+                }
+                for (const T* denotation : iter->second.m_uniqueness) {
+                    function(denotation);
+                }
+                subtract_num_bytes(iter->second.m_num_bytes);
+                shard.m_scopes.erase(iter);
+            }
+        }
+
+        /// @brief Discards the previous generation and the contents of all scopes.
+        void evict() {
+            for (auto& shard : m_shards) {
+                auto lock = shard.lock();
+                shard.m_statistics.num_evictions += shard.m_previous.m_num_entries;
+                subtract_num_bytes(shard.m_previous.m_num_bytes);
+                shard.m_previous = std::move(shard.m_current);
+                shard.m_current = Generation();
+                // Scopes can point to denotations of the current generation.
+                for (auto& scope : shard.m_scopes) {
+                    shard.m_statistics.num_evictions += scope.second.m_num_entries;
+                    subtract_num_bytes(scope.second.m_num_bytes);
+                    scope.second = Generation();
+                }
+            }
+        }
+
+        /// @brief Discards both generations and the contents of all scopes.
+        void clear() {
+            for (auto& shard : m_shards) {
+                auto lock = shard.lock();
+                shard.m_statistics.num_evictions += shard.m_previous.m_num_entries + shard.m_current.m_num_entries;
+                subtract_num_bytes(shard.m_previous.m_num_bytes + shard.m_current.m_num_bytes);
+                shard.m_previous = Generation();
+                shard.m_current = Generation();
+                for (auto& scope : shard.m_scopes) {
+                    shard.m_statistics.num_evictions += scope.second.m_num_entries;
+                    subtract_num_bytes(scope.second.m_num_bytes);
+                    scope.second = Generation();
+                }
+            }
+        }
+
+        std::size_t compute_memory_usage() const {
+            if (m_num_bytes) {
+                return m_num_bytes->load(std::memory_order_relaxed);
+            }
+            std::size_t result = m_shards[0].m_current.m_num_bytes + m_shards[0].m_previous.m_num_bytes;
+            for (const auto& scope : m_shards[0].m_scopes) {
+                result += scope.second.m_num_bytes;
+            }
+            return result;
+        }
+
+        Statistics get_statistics() const {
+            Statistics result;
+            for (const auto& shard : m_shards) {
+                auto lock = shard.lock();
+                result.num_hits += shard.m_statistics.num_hits;
+                result.num_misses += shard.m_statistics.num_misses;
+                result.num_evictions += shard.m_statistics.num_evictions;
+            }
+            result.num_bytes = compute_memory_usage();
+            return result;
+        }
+    };
+
+    /// @brief Stores the shortest distances between all pairs of objects of
+    ///        role denotations as row-major matrices. Role denotations are
+    ///        unique in the caches, such that all distance numericals over
+    ///        equal role denotations in any state share a matrix.
+    struct DistancesCache {
+        using Distance = std::int16_t;
+        using DistanceMatrix = std::vector<Distance>;
+
+        std::unordered_map<const RoleDenotation*, DistanceMatrix> m_distances;
+        /// @brief Role denotations that were requested once without a matrix.
+        std::unordered_set<const RoleDenotation*> m_requested;
+        std::size_t m_memory_usage = 0;
+        std::size_t m_memory_limit = 128 * 1024 * 1024;
+        // Null if the caches are not concurrent.
+        std::unique_ptr<std::mutex> m_mutex;
+
+        /// @brief Locks the cache if it is concurrent. Matrices are computed
+        ///        without holding the lock.
+        std::unique_lock<std::mutex> lock() const {
+            return m_mutex ? std::unique_lock<std::mutex>(*m_mutex) : std::unique_lock<std::mutex>();
+        }
+
+        /// @brief Returns true if a matrix over the given number of objects
+        ///        fits into the memory limit.
+        bool can_insert(int num_objects) const {
+            std::size_t num_bytes = static_cast<std::size_t>(num_objects) * num_objects * sizeof(Distance);
+            return num_objects < std::numeric_limits<Distance>::max()
+                && m_memory_usage + num_bytes <= m_memory_limit;
+        }
+
+        const DistanceMatrix* insert_distances(const RoleDenotation* denotation, DistanceMatrix&& distances) {
+            auto result = m_distances.emplace(denotation, std::move(distances));
+            if (result.second) {
+                m_memory_usage += result.first->second.size() * sizeof(Distance);
+            }
+            return &result.first->second;
         }
 
-        const T* get_denotation(ElementIndex element, InstanceIndex instance, StateIndex state) const {
-            Key key{element, instance, state};
-            auto iter = m_per_element_instance_state_mapping.find(key);
-            if (iter != m_per_element_instance_state_mapping.end()) {
-                return iter->second;
+        /// @brief Discards the matrix of a role denotation that is released.
+        void erase(const RoleDenotation* denotation) {
+            auto iter = m_distances.find(denotation);
+            if (iter != m_distances.end()) {
+                m_memory_usage -= iter->second.size() * sizeof(Distance);
+                m_distances.erase(iter);
+            }
+            m_requested.erase(denotation);
+        }
+
+        const DistanceMatrix* get_distances(const RoleDenotation* denotation) const {
+            auto iter = m_distances.find(denotation);
+            if (iter != m_distances.end()) {
+                return &iter->second;
             }
             return nullptr;
         }
+
+        /// @brief Sets the maximum number of bytes of all matrices.
+        ///        A limit of zero disables the cache.
+        void set_memory_limit(std::size_t num_bytes) {
+            m_memory_limit = num_bytes;
+        }
+
+        /// @brief Discards all matrices. Matrices are keyed by raw pointers
+        ///        and must be discarded when role denotations are evicted.
+        void clear() {
+            m_distances.clear();
+            m_requested.clear();
+            m_memory_usage = 0;
+        }
     };
 
     /// @brief Cache single denotations
@@ -310,15 +1108,114 @@ private:
     Cache<BooleanDenotations> m_boolean_denotations_cache;
     Cache<NumericalDenotations> m_numerical_denotations_cache;
 
+    DistancesCache m_distances_cache;
+
+    std::size_t m_memory_limit;
+    // Number of evaluations that are in progress with these caches.
+    // Concurrent caches track the evaluations of each thread instead.
+    int m_num_evaluations;
+    // Top-level evaluations with concurrent caches hold it shared and
+    // eviction holds it exclusively. Null if the caches are not concurrent.
+    std::unique_ptr<std::shared_mutex> m_evaluation_mutex;
+    // Denotations of a previous run. Null if no file was loaded.
+    std::unique_ptr<DenotationsFile> m_file;
+
     DenotationsCaches(const DenotationsCaches& other) = delete;
     DenotationsCaches& operator=(const DenotationsCaches& other) = delete;
 
+    /// @brief Evicts the previous generation of single denotations and all
+    ///        collections of denotations if the memory limit is exceeded.
+    void evict_if_over_memory_limit();
+
 public:
+    /// @brief Marks an evaluation in progress. Each element evaluation with
+    ///        caches holds one, and eviction only happens when the first one
+    ///        is constructed, such that no raw pointer that is used by an
+    ///        evaluation in progress becomes invalid.
+    class EvaluationGuard {
+    private:
+        DenotationsCaches& m_caches;
+        // Caches that the thread evaluated with when the guard was constructed.
+        const DenotationsCaches* m_previous_caches;
+
+    public:
+        explicit EvaluationGuard(DenotationsCaches& caches);
+        EvaluationGuard(const EvaluationGuard& other) = delete;
+        EvaluationGuard& operator=(const EvaluationGuard& other) = delete;
+        ~EvaluationGuard();
+    };
+
     DenotationsCaches();
+    /// @brief Creates caches that threads can share to evaluate elements on
+    ///        different states concurrently. Each cache is split into the given
+    ///        number of shards with one lock each.
+    /// @param num_shards A power of two. More shards reduce contention.
+    explicit DenotationsCaches(int num_shards);
     ~DenotationsCaches();
     DenotationsCaches(DenotationsCaches&& other);
     DenotationsCaches& operator=(DenotationsCaches&& other);
 
+    /// @brief Sets the maximum number of bytes of all caches. If it is exceeded,
+    ///        the next evaluation evicts the single denotations that were not
+    ///        used since the previous eviction and all collections of denotations.
+    ///        The default is no limit.
+    void set_memory_limit(std::size_t num_bytes);
+    std::size_t get_memory_limit() const;
+    /// @brief Sets the maximum number of bytes of the matrices of pairwise
+    ///        distances that distance numericals share. Role denotations
+    ///        whose matrix does not fit are searched per evaluation instead.
+    ///        A limit of zero disables the matrices. The default is 128 MiB.
+    void set_distances_memory_limit(std::size_t num_bytes);
+    std::size_t get_distances_memory_limit() const;
+    std::size_t compute_memory_usage() const;
+    bool is_concurrent() const;
+
+    /// @brief Returns the counters of each cache by name, e.g., "concept_denotation"
+    ///        for single concept denotations and "concept_denotations" for collections.
+    std::map<std::string, Statistics> get_statistics() const;
+
+    /// @brief Opens a scope for the state. Until the scope is closed, new
+    ///        denotations of dynamic elements in the state are stored
+    ///        separately, such that a search can release them when it is
+    ///        done with the state. Denotations of static elements and
+    ///        collections of denotations are shared as before.
+    void open_state_scope(const State& state);
+    /// @brief Releases the denotations of the state that were inserted since
+    ///        its scope was opened, in time linear in their number. Raw pointers
+    ///        to them become invalid.
+    void close_state_scope(const State& state);
+
+    /// @brief Writes the cached denotations of the elements and their children
+    ///        in the states to a binary file. Elements are identified by their
+    ///        repr and instances by their objects and atoms, such that another
+    ///        run can load the file with different indices. Denotations of a
+    ///        batched evaluation are written if the states are the ones it was
+    ///        given, in the same order. It must not run concurrently with
+    ///        evaluations.
+    void save(const std::string& filename, const std::vector<std::shared_ptr<const BaseElement>>& elements, const States& states) const;
+    /// @brief Maps a file that was written by save into memory. Evaluations
+    ///        look up denotations that are not cached in the file before
+    ///        computing them. Loading validates the records of the file in
+    ///        time linear in their number, but reads no denotation. Stored
+    ///        denotations of a state are only used if its index and its atoms
+    ///        match. Throws std::runtime_error if the file is not valid.
+    void load(const std::string& filename);
+
+    /// @brief Copies the denotation of the element in the state from the
+    ///        loaded file into result and returns true if the file contains it.
+    bool find_stored_denotation(const BaseElement& element, const State& state, ConceptDenotation& result);
+    bool find_stored_denotation(const BaseElement& element, const State& state, RoleDenotation& result);
+    bool find_stored_denotation(const BaseElement& element, const State& state, bool& result);
+    bool find_stored_denotation(const BaseElement& element, const State& state, int& result);
+
+    /// @brief Looks up the denotations of the element in all states in the
+    ///        loaded file, inserts them into the caches, and returns true if
+    ///        the file contains each of them. The result is unspecified otherwise.
+    bool find_stored_denotations(const BaseElement& element, const States& states, ConceptDenotations& result);
+    bool find_stored_denotations(const BaseElement& element, const States& states, RoleDenotations& result);
+    bool find_stored_denotations(const BaseElement& element, const States& states, BooleanDenotations& result);
+    bool find_stored_denotations(const BaseElement& element, const States& states, NumericalDenotations& result);
+
     Cache<ConceptDenotation>& get_concept_denotation_cache();
     Cache<RoleDenotation>& get_role_denotation_cache();
     Cache<bool>& get_boolean_denotation_cache();
@@ -328,6 +1225,8 @@ public:
     Cache<RoleDenotations>& get_role_denotations_cache();
     Cache<BooleanDenotations>& get_boolean_denotations_cache();
     Cache<NumericalDenotations>& get_numerical_denotations_cache();
+
+    DistancesCache& get_distances_cache();
 };
 
 
@@ -597,6 +1496,8 @@ private:
 
     std::unordered_map<std::string, AtomIndex> m_static_atom_name_to_index;
     std::vector<Atom> m_static_atoms;
+    /// @brief Indices of static atoms grouped by the index of their predicate.
+    std::vector<AtomIndices> m_static_atom_indices_by_predicate;
 
     std::unordered_map<std::string, ObjectIndex> m_object_name_to_index;
     std::vector<Object> m_objects;
@@ -658,6 +1559,8 @@ public:
     InstanceIndex get_index() const;
     const std::vector<Atom>& get_atoms() const;
     const std::vector<Atom>& get_static_atoms() const;
+    /// @brief Returns the indices of the static atoms over the given predicate.
+    const AtomIndices& get_static_atom_indices(PredicateIndex predicate_index) const;
     const std::vector<Object>& get_objects() const;
     const Atom& get_atom(const std::string& name) const;
     const Object& get_object(const std::string& name) const;
@@ -671,6 +1574,11 @@ private:
     std::shared_ptr<const InstanceInfo> m_instance_info;
     AtomIndices m_atom_indices;
     int m_index;
+    /// @brief Atom indices grouped by the index of their predicate, built
+    ///        on the first call of get_atom_indices(PredicateIndex). It is
+    ///        published atomically, such that threads can share the state,
+    ///        and copies of the state share it.
+    mutable std::shared_ptr<const std::vector<AtomIndices>> m_atom_indices_by_predicate;
 
 public:
     State(std::shared_ptr<const InstanceInfo> instance_info, const std::vector<Atom>& atoms, StateIndex index=-1);
@@ -709,6 +1617,10 @@ public:
     void set_index(StateIndex index);
     std::shared_ptr<const InstanceInfo> get_instance_info() const;
     const AtomIndices& get_atom_indices() const;
+    /// @brief Returns the indices of the atoms over the given predicate.
+    ///        Elements that only need the atoms of a single predicate
+    ///        use this instead of scanning all atoms of the state.
+    const AtomIndices& get_atom_indices(PredicateIndex predicate_index) const;
     StateIndex get_index() const;
 };
 
@@ -748,6 +1660,9 @@ public:
     /// @return An integer that represents the score.
     virtual int compute_evaluate_time_score() const = 0;
 
+    /// @brief Returns the elements whose denotations this element is computed from.
+    virtual std::vector<const BaseElement*> get_children() const = 0;
+
     /// @brief Overload of the output stream insertion operator (operator<<) for the BaseElement class.
     ///        Outputs a string representation of a BaseElement object to the specified output stream.
     /// @param os The output stream to write the string representation to.
@@ -772,9 +1687,13 @@ class Concept : public BaseElement {
 protected:
     Concept(std::shared_ptr<const VocabularyInfo> vocabulary_info, bool is_static);
     friend class SyntacticElementFactoryImpl;
+    friend class EvaluationProgram;
 
     virtual ConceptDenotation evaluate_impl(const State& state, DenotationsCaches& caches) const = 0;
     virtual ConceptDenotations evaluate_impl(const States& states, DenotationsCaches& caches) const = 0;
+    /// @brief Computes the denotation from the denotations of the children
+    ///        into result, which is empty and has the number of objects of the state.
+    virtual void evaluate_impl(const State& state, const EvaluationOperands& operands, ConceptDenotation& result) const = 0;
 
 public:
     Concept(const Concept& other);
@@ -786,6 +1705,13 @@ public:
     virtual ConceptDenotation evaluate(const State& state) const = 0;
     const ConceptDenotation* evaluate(const State& state, DenotationsCaches& caches) const;
     const ConceptDenotations* evaluate(const States& states, DenotationsCaches& caches) const;
+
+    /// @brief Calls function on the objects of the denotation in the state
+    ///        until it returns false. Elements that can produce objects
+    ///        incrementally, e.g., from the atoms of the state, do so without
+    ///        computing the denotation. Objects may be visited more than once.
+    /// @return false iff function returned false.
+    virtual bool for_each(const State& state, const std::function<bool(ObjectIndex)>& function) const;
 };
 
 
@@ -795,9 +1721,13 @@ class Role : public BaseElement {
 protected:
     Role(std::shared_ptr<const VocabularyInfo> vocabulary_info, bool is_static);
     friend class SyntacticElementFactoryImpl;
+    friend class EvaluationProgram;
 
     virtual RoleDenotation evaluate_impl(const State& state, DenotationsCaches& caches) const = 0;
     virtual RoleDenotations evaluate_impl(const States& states, DenotationsCaches& caches) const = 0;
+    /// @brief Computes the denotation from the denotations of the children
+    ///        into result, which is empty and has the number of objects of the state.
+    virtual void evaluate_impl(const State& state, const EvaluationOperands& operands, RoleDenotation& result) const = 0;
 
 public:
     Role(const Role& other);
@@ -809,6 +1739,13 @@ public:
     virtual RoleDenotation evaluate(const State& state) const = 0;
     const RoleDenotation* evaluate(const State& state, DenotationsCaches& caches) const;
     const RoleDenotations* evaluate(const States& states, DenotationsCaches& caches) const;
+
+    /// @brief Calls function on the pairs of the denotation in the state
+    ///        until it returns false. Elements that can produce pairs
+    ///        incrementally, e.g., from the atoms of the state, do so without
+    ///        computing the denotation. Pairs may be visited more than once.
+    /// @return false iff function returned false.
+    virtual bool for_each(const State& state, const std::function<bool(const PairOfObjectIndices&)>& function) const;
 };
 
 
@@ -818,9 +1755,12 @@ class Numerical : public BaseElement {
 protected:
     Numerical(std::shared_ptr<const VocabularyInfo> vocabulary_info, bool is_static);
     friend class SyntacticElementFactoryImpl;
+    friend class EvaluationProgram;
 
     virtual int evaluate_impl(const State& state, DenotationsCaches& caches) const = 0;
     virtual NumericalDenotations evaluate_impl(const States& states, DenotationsCaches& caches) const = 0;
+    /// @brief Computes the denotation from the denotations of the children.
+    virtual int evaluate_impl(const State& state, const EvaluationOperands& operands) const = 0;
 
 public:
     Numerical(const Numerical& other);
@@ -841,9 +1781,12 @@ class Boolean : public BaseElement {
 protected:
     Boolean(std::shared_ptr<const VocabularyInfo> vocabulary_info, bool is_static);
     friend class SyntacticElementFactoryImpl;
+    friend class EvaluationProgram;
 
     virtual bool evaluate_impl(const State& state, DenotationsCaches& caches) const = 0;
     virtual BooleanDenotations evaluate_impl(const States& states, DenotationsCaches& caches) const = 0;
+    /// @brief Computes the denotation from the denotations of the children.
+    virtual bool evaluate_impl(const State& state, const EvaluationOperands& operands) const = 0;
 
 public:
     Boolean(const Boolean& other);
@@ -858,6 +1801,115 @@ public:
 };
 
 
+/// @brief Provides the denotations of the children of an element during the
+///        execution of an EvaluationProgram.
+class EvaluationOperands {
+private:
+    using Operand = std::pair<const BaseElement*, int>;
+
+    const Operand* m_begin;
+    const Operand* m_end;
+    const std::vector<ConceptDenotation>* m_concept_registers;
+    const std::vector<RoleDenotation>* m_role_registers;
+
+    EvaluationOperands(const Operand* begin, const Operand* end, const std::vector<ConceptDenotation>* concept_registers, const std::vector<RoleDenotation>* role_registers);
+
+    int get_register(const BaseElement& element) const;
+
+    friend class EvaluationProgram;
+
+public:
+    const ConceptDenotation& get_denotation(const Concept& element) const;
+    const RoleDenotation& get_denotation(const Role& element) const;
+};
+
+
+/// @brief Evaluates a fixed set of Booleans and Numericals on a sequence of
+///        states without caches, or with caches to reuse their denotations.
+///
+/// The elements are compiled into a flat list of instructions in topological
+/// order, in which shared children occur once. Each intermediate denotation
+/// is written into a register that is reused as soon as its last reader was
+/// executed, such that evaluating a state neither allocates nor hashes.
+/// Instructions of static elements only run when the instance changes.
+class EvaluationProgram {
+private:
+    enum class ElementType { CONCEPT, ROLE, BOOLEAN, NUMERICAL };
+
+    /*
+      Fused kernels evaluate a common shape of elements without
+      materializing the denotation of the inner element, e.g.,
+      COUNT_SOME evaluates n_count(c_some(R,C)) from R and C.
+    */
+    enum class Kernel {
+        ELEMENT,
+        SOME_PRIMITIVE,        // c_some(r_primitive(p,i,j),C)
+        COUNT_SOME,            // n_count(c_some(R,C))
+        COUNT_AND,             // n_count(c_and(C,D))
+        EMPTY_SOME,            // b_empty(c_some(R,C))
+        EMPTY_SOME_PRIMITIVE,  // b_empty(c_some(r_primitive(p,i,j),C))
+        EMPTY_AND              // b_empty(c_and(C,D))
+    };
+
+    struct Instruction {
+        const BaseElement* element;
+        ElementType type;
+        Kernel kernel;
+        // The r_primitive of SOME_PRIMITIVE and EMPTY_SOME_PRIMITIVE.
+        const BaseElement* primitive;
+        // Index of the register for concepts and roles
+        // and index of the output for booleans and numericals.
+        int result;
+        int operands_begin;
+        int operands_end;
+    };
+
+    std::vector<std::shared_ptr<const Boolean>> m_booleans;
+    std::vector<std::shared_ptr<const Numerical>> m_numericals;
+
+    std::vector<Instruction> m_static_instructions;
+    std::vector<Instruction> m_dynamic_instructions;
+    std::vector<EvaluationOperands::Operand> m_operands;
+
+    int m_num_concept_registers;
+    int m_num_role_registers;
+    std::vector<ConceptDenotation> m_concept_registers;
+    std::vector<RoleDenotation> m_role_registers;
+
+    BooleanDenotations m_boolean_denotations;
+    NumericalDenotations m_numerical_denotations;
+
+    // The instance of the most recently evaluated state.
+    std::shared_ptr<const InstanceInfo> m_instance_info;
+
+    void execute(const Instruction& instruction, const State& state);
+
+public:
+    EvaluationProgram(const std::vector<std::shared_ptr<const Boolean>>& booleans, const std::vector<std::shared_ptr<const Numerical>>& numericals);
+    EvaluationProgram(const EvaluationProgram& other);
+    EvaluationProgram& operator=(const EvaluationProgram& other);
+    EvaluationProgram(EvaluationProgram&& other);
+    EvaluationProgram& operator=(EvaluationProgram&& other);
+    ~EvaluationProgram();
+
+    /// @brief Evaluates all Booleans and Numericals on the state.
+    void evaluate(const State& state);
+    /// @brief Evaluates all Booleans and Numericals on the state unless the
+    ///        caches or their loaded file contain all of their denotations.
+    ///        Computed denotations are inserted into the caches, such that
+    ///        they can be saved. Intermediate denotations are not cached.
+    void evaluate(const State& state, DenotationsCaches& caches);
+
+    /// @brief Returns the denotations of the most recently evaluated state
+    ///        in the order of the constructor arguments.
+    const BooleanDenotations& get_boolean_denotations() const;
+    const NumericalDenotations& get_numerical_denotations() const;
+
+    int get_num_instructions() const;
+    int get_num_registers() const;
+};
+
+
 /// @brief Provides functionality for the syntactically unique creation of elements.
 class SyntacticElementFactory {
 private:
@@ -40,6 +40,21 @@ public:
         int distance_numerical_complexity_limit=9,
         int time_limit=3600,
         int feature_limit=10000);
+    /// @brief Generates features with the given caches, e.g., caches that
+    ///        loaded the denotations of a previous run over the same states.
+    ///        The caches keep the denotations of all generated elements,
+    ///        such that they can be saved with the same states for the next run.
+    FeatureRepresentations generate(
+        core::SyntacticElementFactory& factory,
+        const core::States& states,
+        core::DenotationsCaches& caches,
+        int concept_complexity_limit=9,
+        int role_complexity_limit=9,
+        int boolean_complexity_limit=9,
+        int count_numerical_complexity_limit=9,
+        int distance_numerical_complexity_limit=9,
+        int time_limit=3600,
+        int feature_limit=10000);
 
     void set_generate_empty_boolean(bool enable);
     void set_generate_inclusion_boolean(bool enable);
@@ -0,0 +1,54 @@
+#ifndef DLPLAN_INCLUDE_DLPLAN_UTILS_ALIGNED_ALLOCATOR_H_
+#define DLPLAN_INCLUDE_DLPLAN_UTILS_ALIGNED_ALLOCATOR_H_
+
+#include <cstddef>
+#include <new>
+
+
+namespace dlplan::utils {
+
+/**
+ * Minimal allocator that returns memory aligned to Alignment bytes.
+ * We use it for the blocks of DynamicBitset such that vector loads
+ * never straddle a cache line.
+ */
+template<typename T, std::size_t Alignment>
+class AlignedAllocator {
+    static_assert(Alignment >= alignof(T), "Alignment must be at least alignof(T)");
+    static_assert((Alignment & (Alignment - 1)) == 0, "Alignment must be a power of two");
+
+public:
+    using value_type = T;
+
+    template<typename U>
+    struct rebind {
+        using other = AlignedAllocator<U, Alignment>;
+    };
+
+    AlignedAllocator() noexcept = default;
+
+    template<typename U>
+    AlignedAllocator(const AlignedAllocator<U, Alignment>&) noexcept { }
+
+    T* allocate(std::size_t n) {
+        return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(Alignment)));
+    }
+
+    void deallocate(T* ptr, std::size_t) noexcept {
+        ::operator delete(ptr, std::align_val_t(Alignment));
+    }
+
+    template<typename U>
+    bool operator==(const AlignedAllocator<U, Alignment>&) const noexcept {
+        return true;
+    }
+
+    template<typename U>
+    bool operator!=(const AlignedAllocator<U, Alignment>&) const noexcept {
+        return false;
+    }
+};
+
+}
+
+#endif
@@ -0,0 +1,118 @@
+#ifndef DLPLAN_INCLUDE_DLPLAN_UTILS_ARENA_H_
+#define DLPLAN_INCLUDE_DLPLAN_UTILS_ARENA_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+namespace dlplan::utils {
+
+/**
+ * Bump allocator for objects of type T. Objects are constructed into
+ * contiguous chunks that grow geometrically and are never moved,
+ * such that pointers to them remain valid until the arena is destroyed
+ * or cleared. All objects are destroyed and released in bulk.
+ */
+template<typename T>
+class ObjectArena {
+private:
+    struct Chunk {
+        T* data;
+        std::size_t size;
+        std::size_t capacity;
+    };
+
+    static constexpr std::size_t INITIAL_CHUNK_CAPACITY = 64;
+    static constexpr std::size_t MAX_CHUNK_CAPACITY = 8192;
+
+    std::vector<Chunk> m_chunks;
+    std::size_t m_num_objects;
+
+    void allocate_chunk() {
+        std::size_t capacity = m_chunks.empty()
+            ? INITIAL_CHUNK_CAPACITY
+            : std::min(2 * m_chunks.back().capacity, MAX_CHUNK_CAPACITY);
+        T* data = static_cast<T*>(::operator new(capacity * sizeof(T), std::align_val_t(alignof(T))));
+        m_chunks.push_back(Chunk{data, 0, capacity});
+    }
+
+public:
+    ObjectArena() : m_num_objects(0) { }
+
+    ObjectArena(const ObjectArena& other) = delete;
+    ObjectArena& operator=(const ObjectArena& other) = delete;
+
+    ObjectArena(ObjectArena&& other) noexcept
+        : m_chunks(std::move(other.m_chunks)), m_num_objects(other.m_num_objects) {
+        other.m_chunks.clear();
+        other.m_num_objects = 0;
+    }
+
+    ObjectArena& operator=(ObjectArena&& other) noexcept {
+        if (this != &other) {
+            clear();
+            m_chunks = std::move(other.m_chunks);
+            m_num_objects = other.m_num_objects;
+            other.m_chunks.clear();
+            other.m_num_objects = 0;
+        }
+        return *this;
+    }
+
+    ~ObjectArena() {
+        clear();
+    }
+
+    /// @brief Constructs an object in the arena.
+    /// @return A pointer to the object that remains valid until the arena is cleared.
+    template<typename... Args>
+    T* emplace(Args&&... args) {
+        if (m_chunks.empty() || m_chunks.back().size == m_chunks.back().capacity) {
+            allocate_chunk();
+        }
+        Chunk& chunk = m_chunks.back();
+        T* object = new (chunk.data + chunk.size) T(std::forward<Args>(args)...);
+        ++chunk.size;
+        ++m_num_objects;
+        return object;
+    }
+
+    /// @brief Destroys all objects and releases all memory.
+    void clear() {
+        for (Chunk& chunk : m_chunks) {
+            if constexpr (!std::is_trivially_destructible<T>::value) {
+                for (std::size_t i = 0; i < chunk.size; ++i) {
+                    chunk.data[i].~T();
+                }
+            }
+            ::operator delete(chunk.data, std::align_val_t(alignof(T)));
+        }
+        m_chunks.clear();
+        m_num_objects = 0;
+    }
+
+    std::size_t size() const {
+        return m_num_objects;
+    }
+
+    std::size_t get_num_chunks() const {
+        return m_chunks.size();
+    }
+
+    /// @brief Returns the number of bytes allocated for objects, excluding their own heap memory.
+    std::size_t compute_memory_usage() const {
+        std::size_t result = 0;
+        for (const Chunk& chunk : m_chunks) {
+            result += chunk.capacity * sizeof(T);
+        }
+        return result;
+    }
+};
+
+}
+
+#endif
@@ -0,0 +1,51 @@
+/// @brief Provides vectorized kernels for set operations on arrays of 64-bit blocks.
+
+#ifndef DLPLAN_INCLUDE_DLPLAN_UTILS_BITSET_KERNELS_H_
+#define DLPLAN_INCLUDE_DLPLAN_UTILS_BITSET_KERNELS_H_
+
+#include <cstddef>
+#include <cstdint>
+
+
+/**
+ * The kernels are selected once at runtime depending on the instruction
+ * sets supported by the CPU (AVX2, SSE2, or a portable scalar fallback).
+ * All kernels accept unaligned pointers.
+ */
+namespace dlplan::utils::bitset_kernels {
+
+using Block = std::uint64_t;
+
+/**
+ * Below this number of blocks, the call overhead dominates and
+ * DynamicBitset uses inlined scalar loops instead.
+ */
+const std::size_t MIN_NUM_BLOCKS = 4;
+
+/// @brief dst[i] &= src[i]
+extern void and_assign(Block* dst, const Block* src, std::size_t num_blocks);
+
+/// @brief dst[i] |= src[i]
+extern void or_assign(Block* dst, const Block* src, std::size_t num_blocks);
+
+/// @brief dst[i] &= ~src[i]
+extern void diff_assign(Block* dst, const Block* src, std::size_t num_blocks);
+
+/// @brief dst[i] = ~dst[i]
+extern void negate(Block* dst, std::size_t num_blocks);
+
+/// @brief Returns true iff left[i] & right[i] != 0 for some i. Exits early.
+extern bool intersects(const Block* left, const Block* right, std::size_t num_blocks);
+
+/// @brief Returns true iff left[i] & ~right[i] == 0 for all i. Exits early.
+extern bool is_subset_of(const Block* left, const Block* right, std::size_t num_blocks);
+
+/// @brief Returns the number of set bits.
+extern int count(const Block* data, std::size_t num_blocks);
+
+/// @brief Returns the name of the instruction set of the selected kernels.
+extern const char* get_instruction_set();
+
+}
+
+#endif
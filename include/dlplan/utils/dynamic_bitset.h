@@ -1,10 +1,17 @@
 #ifndef DLPLAN_INCLUDE_DLPLAN_UTILS_DYNAMIC_BITSET_H
 #define DLPLAN_INCLUDE_DLPLAN_UTILS_DYNAMIC_BITSET_H
 
+#include "aligned_allocator.h"
+#include "bitset_kernels.h"
 #include "hash.h"
+#include "small_vector.h"
 
+#include <algorithm>
 #include <cassert>
+#include <cstddef>
+#include <cstdint>
 #include <limits>
+#include <type_traits>
 #include <vector>
 
 
@@ -13,20 +20,110 @@
 */
 namespace dlplan::utils {
 
-template<typename Block = unsigned int>
-class DynamicBitset {
+namespace bitset_detail {
+/*
+  Word-level bit operations. We use the compiler builtins that map to
+  popcnt/tzcnt where available and fall back to portable loops otherwise.
+*/
+template<typename Block>
+inline int popcount(Block block) {
+    static_assert(sizeof(Block) <= sizeof(unsigned long long), "Block type is too wide");
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_popcountll(static_cast<unsigned long long>(block));
+#else
+    int result = 0;
+    while (block) {
+        block &= block - 1;
+        ++result;
+    }
+    return result;
+#endif
+}
+
+/*
+  Returns the index of the least significant set bit. Block must not be zero.
+*/
+template<typename Block>
+inline int count_trailing_zeros(Block block) {
+    static_assert(sizeof(Block) <= sizeof(unsigned long long), "Block type is too wide");
+    assert(block != 0);
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(static_cast<unsigned long long>(block));
+#else
+    int result = 0;
+    while (!(block & Block(1))) {
+        block >>= 1;
+        ++result;
+    }
+    return result;
+#endif
+}
+
+/*
+  Contribution of a block to the incremental hash value. The hash value
+  is the XOR over all blocks, such that changing one block only requires
+  removing its old and adding its new contribution. Zero blocks do not
+  contribute.
+*/
+template<typename Block>
+inline std::uint64_t hash_block(std::size_t index, Block block) {
+    if (!block) {
+        return 0;
+    }
+    // Finalizer of MurmurHash3 applied to the position and the value.
+    auto fmix64 = [](std::uint64_t h) {
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+        h *= 0xc4ceb9fe1a85ec53ULL;
+        h ^= h >> 33;
+        return h;
+    };
+    return fmix64(static_cast<std::uint64_t>(block) ^ fmix64(index + 1));
+}
+
+template<bool Enabled>
+struct IncrementalHash {
+    std::uint64_t hash_value = 0;
+};
+
+template<>
+struct IncrementalHash<false> { };
+}
+
+/*
+  If IncrementalHashing is true, the bitset keeps an XOR-composable hash
+  value up to date: O(1) for modifying single bits and O(number of blocks)
+  for bulk operations, which then run as scalar loops instead of the
+  vectorized kernels. hash() then returns the maintained value in O(1).
+*/
+template<typename Block = std::uint64_t, std::size_t NumInlineBlocks = 0, bool IncrementalHashing = false>
+class DynamicBitset : private bitset_detail::IncrementalHash<IncrementalHashing> {
     static_assert(
         !std::numeric_limits<Block>::is_signed,
         "Block type must be unsigned");
 
-    std::vector<Block> blocks;
+    /*
+      Blocks are 32-byte aligned such that a 256-bit vector load never
+      straddles two cache lines. For 64-bit blocks, the set operations
+      on large bitsets are delegated to the vectorized bitset_kernels.
+      If NumInlineBlocks is positive, bitsets with at most that many
+      blocks are stored inline without a heap allocation. Inline blocks
+      are only 8-byte aligned, which the kernels accept.
+    */
+    using Blocks = typename std::conditional<
+        NumInlineBlocks == 0,
+        std::vector<Block, AlignedAllocator<Block, 32>>,
+        SmallVector<Block, NumInlineBlocks, 32>>::type;
+
+    Blocks blocks;
     std::size_t num_bits;
 
+    static constexpr bool use_kernels = std::is_same<Block, bitset_kernels::Block>::value;
+
     static const Block zeros;
     static const Block ones;
 
-    static const int bits_per_block = std::numeric_limits<Block>::digits;
-
     static int compute_num_blocks(std::size_t num_bits) {
         return num_bits / bits_per_block +
                static_cast<int>(num_bits % bits_per_block != 0);
@@ -48,16 +145,45 @@ class DynamicBitset {
         return bit_index(num_bits);
     }
 
+    /*
+      Returns the position of the lowest set bit in blocks[first_block..],
+      or npos if there is none.
+    */
+    std::size_t find_from_block(std::size_t first_block) const {
+        for (std::size_t i = first_block; i < blocks.size(); ++i) {
+            if (blocks[i]) {
+                return i * bits_per_block + bitset_detail::count_trailing_zeros(blocks[i]);
+            }
+        }
+        return npos;
+    }
+
     void zero_unused_bits() {
         const int bits_in_last_block = count_bits_in_last_block();
 
         if (bits_in_last_block != 0) {
             assert(!blocks.empty());
-            blocks.back() &= ~(ones << bits_in_last_block);
+            update_block(blocks.size() - 1, blocks.back() & ~(ones << bits_in_last_block));
+        }
+    }
+
+    /*
+      Assigns the value to the block and updates the incremental hash value.
+    */
+    void update_block(std::size_t index, Block value) {
+        if constexpr (IncrementalHashing) {
+            if (blocks[index] != value) {
+                this->hash_value ^= bitset_detail::hash_block(index, blocks[index]) ^ bitset_detail::hash_block(index, value);
+            }
         }
+        blocks[index] = value;
     }
 
 public:
+    static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+    static constexpr int bits_per_block = std::numeric_limits<Block>::digits;
+
     explicit DynamicBitset(std::size_t num_bits)
         : blocks(compute_num_blocks(num_bits), zeros),
           num_bits(num_bits) {
@@ -68,19 +194,114 @@ public:
     }
 
     /*
-      Count the number of set bits.
+      Raw access to the blocks, e.g., for operating on a range of blocks
+      that represents one row of a bit matrix.
+    */
+    std::size_t num_blocks() const {
+        return blocks.size();
+    }
 
-      The computation could be made faster by using a more sophisticated
-      algorithm (see https://en.wikipedia.org/wiki/Hamming_weight).
+    const Block* data() const {
+        return blocks.data();
+    }
+
+    /*
+      With incremental hashing, call recompute_hash after writing blocks
+      through the raw pointer.
     */
-    int count() const {
+    Block* data() {
+        return blocks.data();
+    }
+
+    void recompute_hash() {
+        if constexpr (IncrementalHashing) {
+            this->hash_value = 0;
+            for (std::size_t i = 0; i < blocks.size(); ++i) {
+                this->hash_value ^= bitset_detail::hash_block(i, blocks[i]);
+            }
+        }
+    }
+
+    /*
+      Operations on the range of num_blocks blocks starting at first_block,
+      e.g., one row of a bit matrix, with the same number of blocks in src.
+    */
+    int count(std::size_t first_block, std::size_t num_blocks) const {
+        assert(first_block + num_blocks <= blocks.size());
+        const Block* data = blocks.data() + first_block;
+        if constexpr (use_kernels) {
+            if (num_blocks >= bitset_kernels::MIN_NUM_BLOCKS) {
+                return bitset_kernels::count(data, num_blocks);
+            }
+        }
         int result = 0;
-        for (std::size_t pos = 0; pos < num_bits; ++pos) {
-            result += static_cast<int>(test(pos));
+        for (std::size_t i = 0; i < num_blocks; ++i) {
+            result += bitset_detail::popcount(data[i]);
         }
         return result;
     }
 
+    void and_assign(std::size_t first_block, const Block* src, std::size_t num_blocks) {
+        assert(first_block + num_blocks <= blocks.size());
+        if constexpr (use_kernels && !IncrementalHashing) {
+            if (num_blocks >= bitset_kernels::MIN_NUM_BLOCKS) {
+                bitset_kernels::and_assign(blocks.data() + first_block, src, num_blocks);
+                return;
+            }
+        }
+        for (std::size_t i = 0; i < num_blocks; ++i) {
+            update_block(first_block + i, blocks[first_block + i] & src[i]);
+        }
+    }
+
+    void or_assign(std::size_t first_block, const Block* src, std::size_t num_blocks) {
+        assert(first_block + num_blocks <= blocks.size());
+        if constexpr (use_kernels && !IncrementalHashing) {
+            if (num_blocks >= bitset_kernels::MIN_NUM_BLOCKS) {
+                bitset_kernels::or_assign(blocks.data() + first_block, src, num_blocks);
+                return;
+            }
+        }
+        for (std::size_t i = 0; i < num_blocks; ++i) {
+            update_block(first_block + i, blocks[first_block + i] | src[i]);
+        }
+    }
+
+    /*
+      Count the number of set bits. Unused bits in the last block are
+      always zero, so we can count whole blocks.
+    */
+    int count() const {
+        return count(0, blocks.size());
+    }
+
+    /*
+      Returns the position of the first set bit, or npos if no bit is set.
+    */
+    std::size_t find_first() const {
+        return find_from_block(0);
+    }
+
+    /*
+      Returns the position of the first set bit after pos, or npos if
+      there is none. Together with find_first this allows iterating over
+      the set bits in O(number of blocks + number of set bits):
+
+        for (auto pos = b.find_first(); pos != b.npos; pos = b.find_next(pos)) ...
+    */
+    std::size_t find_next(std::size_t pos) const {
+        ++pos;
+        if (pos >= num_bits) {
+            return npos;
+        }
+        const std::size_t block = block_index(pos);
+        const Block remaining = blocks[block] & (ones << bit_index(pos));
+        if (remaining) {
+            return block * bits_per_block + bitset_detail::count_trailing_zeros(remaining);
+        }
+        return find_from_block(block + 1);
+    }
+
     bool none() const {
         for (std::size_t i = 0; i < blocks.size(); ++i) {
             if (blocks[i]) return false;
@@ -90,21 +311,26 @@ public:
 
     void set() {
         std::fill(blocks.begin(), blocks.end(), ones);
-        zero_unused_bits();
+        const int bits_in_last_block = count_bits_in_last_block();
+        if (bits_in_last_block != 0) {
+            blocks.back() &= ~(ones << bits_in_last_block);
+        }
+        recompute_hash();
     }
 
     void reset() {
         std::fill(blocks.begin(), blocks.end(), zeros);
+        recompute_hash();
     }
 
     void set(std::size_t pos) {
         assert(pos < num_bits);
-        blocks[block_index(pos)] |= bit_mask(pos);
+        update_block(block_index(pos), blocks[block_index(pos)] | bit_mask(pos));
     }
 
     void reset(std::size_t pos) {
         assert(pos < num_bits);
-        blocks[block_index(pos)] &= ~bit_mask(pos);
+        update_block(block_index(pos), blocks[block_index(pos)] & ~bit_mask(pos));
     }
 
     bool test(std::size_t pos) const {
@@ -118,6 +344,9 @@ public:
 
     bool operator==(const DynamicBitset& other) const {
         if (this != &other) {
+            if constexpr (IncrementalHashing) {
+                if (this->hash_value != other.hash_value) return false;
+            }
             return (blocks == other.blocks) && (num_bits == other.num_bits);
         }
         return true;
@@ -129,38 +358,56 @@ public:
 
     DynamicBitset& operator&=(const DynamicBitset& other) {
         assert(size() == other.size());
-        for (std::size_t i = 0; i < blocks.size(); ++i) {
-            blocks[i] &= other.blocks[i];
-        }
+        and_assign(0, other.blocks.data(), blocks.size());
         return *this;
     }
 
     DynamicBitset& operator|=(const DynamicBitset& other) {
         assert(size() == other.size());
-        for (std::size_t i = 0; i < blocks.size(); ++i) {
-            blocks[i] |= other.blocks[i];
-        }
+        or_assign(0, other.blocks.data(), blocks.size());
         return *this;
     }
 
     DynamicBitset& operator-=(const DynamicBitset& other) {
         assert(size() == other.size());
+        if constexpr (use_kernels && !IncrementalHashing) {
+            if (blocks.size() >= bitset_kernels::MIN_NUM_BLOCKS) {
+                bitset_kernels::diff_assign(blocks.data(), other.blocks.data(), blocks.size());
+                return *this;
+            }
+        }
         for (std::size_t i = 0; i < blocks.size(); ++i) {
-            blocks[i] = blocks[i] & ~other.blocks[i];
+            update_block(i, blocks[i] & ~other.blocks[i]);
         }
         return *this;
     }
 
     DynamicBitset& operator~() {
+        if constexpr (use_kernels && !IncrementalHashing) {
+            if (blocks.size() >= bitset_kernels::MIN_NUM_BLOCKS) {
+                bitset_kernels::negate(blocks.data(), blocks.size());
+                zero_unused_bits();
+                return *this;
+            }
+        }
+        const int bits_in_last_block = count_bits_in_last_block();
         for (std::size_t i = 0; i < blocks.size(); ++i) {
-            blocks[i] = ~blocks[i];
+            Block value = ~blocks[i];
+            if (i + 1 == blocks.size() && bits_in_last_block != 0) {
+                value &= ~(ones << bits_in_last_block);
+            }
+            update_block(i, value);
         }
-        zero_unused_bits();
         return *this;
     }
 
     bool intersects(const DynamicBitset &other) const {
         assert(size() == other.size());
+        if constexpr (use_kernels) {
+            if (blocks.size() >= bitset_kernels::MIN_NUM_BLOCKS) {
+                return bitset_kernels::intersects(blocks.data(), other.blocks.data(), blocks.size());
+            }
+        }
         for (std::size_t i = 0; i < blocks.size(); ++i) {
             if (blocks[i] & other.blocks[i])
                 return true;
@@ -168,8 +415,22 @@ public:
         return false;
     }
 
+    int count_intersection(const DynamicBitset &other) const {
+        assert(size() == other.size());
+        int result = 0;
+        for (std::size_t i = 0; i < blocks.size(); ++i) {
+            result += bitset_detail::popcount(blocks[i] & other.blocks[i]);
+        }
+        return result;
+    }
+
     bool is_subset_of(const DynamicBitset &other) const {
         assert(size() == other.size());
+        if constexpr (use_kernels) {
+            if (blocks.size() >= bitset_kernels::MIN_NUM_BLOCKS) {
+                return bitset_kernels::is_subset_of(blocks.data(), other.blocks.data(), blocks.size());
+            }
+        }
         for (std::size_t i = 0; i < blocks.size(); ++i) {
             if (blocks[i] & ~other.blocks[i])
                 return false;
@@ -178,15 +439,18 @@ public:
     }
 
     std::size_t hash() const {
-        return dlplan::utils::hash<std::vector<Block>>()(blocks);
+        if constexpr (IncrementalHashing) {
+            return this->hash_value;
+        }
+        return dlplan::utils::hash_bytes(blocks.data(), blocks.size() * sizeof(Block), blocks.size());
     }
 };
 
-template<typename Block>
-const Block DynamicBitset<Block>::zeros = Block(0);
+template<typename Block, std::size_t NumInlineBlocks, bool IncrementalHashing>
+const Block DynamicBitset<Block, NumInlineBlocks, IncrementalHashing>::zeros = Block(0);
 
-template<typename Block>
-const Block DynamicBitset<Block>::ones = ~DynamicBitset<Block>::zeros;
+template<typename Block, std::size_t NumInlineBlocks, bool IncrementalHashing>
+const Block DynamicBitset<Block, NumInlineBlocks, IncrementalHashing>::ones = ~DynamicBitset<Block, NumInlineBlocks, IncrementalHashing>::zeros;
 }
 
 /*
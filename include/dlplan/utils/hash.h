@@ -4,6 +4,7 @@
 #define DLPLAN_INCLUDE_DLPLAN_UTILS_HASH_H_
 
 #include <cstddef>
+#include <cstdint>
 #include <vector>
 #include <stdexcept>
 
@@ -21,6 +22,12 @@ void hash_combine(std::size_t& seed, const T& v)
     seed ^= hasher(v) + 0x9e3779b9 + (seed<<6) + (seed>>2);
 }
 
+/**
+ * Hashes a contiguous range of bytes with MurmurHash3 x64_128.
+ * We use it for hashing denotations block-wise.
+ */
+extern std::size_t hash_bytes(const void* data, std::size_t num_bytes, std::uint32_t seed);
+
 template<typename T>
 struct hash_impl {
     std::size_t operator()(const T&) const {
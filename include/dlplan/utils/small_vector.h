@@ -0,0 +1,130 @@
+#ifndef DLPLAN_INCLUDE_DLPLAN_UTILS_SMALL_VECTOR_H_
+#define DLPLAN_INCLUDE_DLPLAN_UTILS_SMALL_VECTOR_H_
+
+#include "aligned_allocator.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <type_traits>
+
+
+namespace dlplan::utils {
+
+/**
+ * Fixed-size array of trivially copyable elements whose size is chosen at
+ * construction. Up to N elements are stored inline in the object itself,
+ * larger arrays are allocated on the heap aligned to Alignment bytes.
+ * It implements the subset of std::vector that DynamicBitset uses.
+ */
+template<typename T, std::size_t N, std::size_t Alignment = 32>
+class SmallVector {
+    static_assert(std::is_trivially_copyable<T>::value, "T must be trivially copyable");
+    static_assert(N > 0, "N must be positive");
+
+    using Allocator = AlignedAllocator<T, Alignment>;
+
+    // The inline buffer and the heap pointer are never used at the same time.
+    union {
+        T m_inline[N];
+        T* m_heap;
+    };
+    std::size_t m_size;
+
+    bool is_inline() const {
+        return m_size <= N;
+    }
+
+    void allocate(std::size_t size) {
+        m_size = size;
+        if (!is_inline()) {
+            m_heap = Allocator().allocate(size);
+        }
+    }
+
+    void deallocate() {
+        if (!is_inline()) {
+            Allocator().deallocate(m_heap, m_size);
+        }
+    }
+
+    void steal(SmallVector& other) {
+        m_size = other.m_size;
+        if (other.is_inline()) {
+            std::copy(other.begin(), other.end(), m_inline);
+        } else {
+            m_heap = other.m_heap;
+            other.m_size = 0;
+        }
+    }
+
+public:
+    using value_type = T;
+    using iterator = T*;
+    using const_iterator = const T*;
+
+    SmallVector(std::size_t size, const T& value) {
+        allocate(size);
+        std::fill(begin(), end(), value);
+    }
+
+    SmallVector(const SmallVector& other) {
+        allocate(other.m_size);
+        std::copy(other.begin(), other.end(), begin());
+    }
+
+    SmallVector& operator=(const SmallVector& other) {
+        if (this != &other) {
+            if (m_size != other.m_size) {
+                deallocate();
+                allocate(other.m_size);
+            }
+            std::copy(other.begin(), other.end(), begin());
+        }
+        return *this;
+    }
+
+    SmallVector(SmallVector&& other) noexcept {
+        steal(other);
+    }
+
+    SmallVector& operator=(SmallVector&& other) noexcept {
+        if (this != &other) {
+            deallocate();
+            steal(other);
+        }
+        return *this;
+    }
+
+    ~SmallVector() {
+        deallocate();
+    }
+
+    std::size_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+
+    T* data() { return is_inline() ? m_inline : m_heap; }
+    const T* data() const { return is_inline() ? m_inline : m_heap; }
+
+    T& operator[](std::size_t pos) { return data()[pos]; }
+    const T& operator[](std::size_t pos) const { return data()[pos]; }
+
+    T& back() { return data()[m_size - 1]; }
+    const T& back() const { return data()[m_size - 1]; }
+
+    iterator begin() { return data(); }
+    iterator end() { return data() + m_size; }
+    const_iterator begin() const { return data(); }
+    const_iterator end() const { return data() + m_size; }
+
+    bool operator==(const SmallVector& other) const {
+        return m_size == other.m_size && std::equal(begin(), end(), other.begin());
+    }
+
+    bool operator!=(const SmallVector& other) const {
+        return !(*this == other);
+    }
+};
+
+}
+
+#endif
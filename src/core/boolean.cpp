@@ -19,24 +19,54 @@ Boolean& Boolean::operator=(Boolean&& other) = default;
 Boolean::~Boolean() = default;
 
 bool Boolean::evaluate(const State& state, DenotationsCaches& caches) const {
+    DenotationsCaches::EvaluationGuard guard(caches);
     const bool* cached = caches.get_boolean_denotation_cache().get_denotation(
         get_index(),
         state.get_instance_info()->get_index(),
         is_static() ? -1 : state.get_index());
     if (cached) return *cached;
-    const bool* denotation = caches.get_boolean_denotation_cache().insert_denotation(evaluate_impl(state, caches));
-    caches.get_boolean_denotation_cache().insert_denotation(
+    // Denotations of a previous run are inserted instead of computed.
+    bool stored = false;
+    bool is_stored = caches.find_stored_denotation(*this, state, stored);
+    const bool* denotation = caches.get_boolean_denotation_cache().insert_denotation(
         get_index(),
         state.get_instance_info()->get_index(),
         is_static() ? -1 : state.get_index(),
-        denotation);
+        is_stored ? std::move(stored) : evaluate_impl(state, caches));
     return *denotation;
 }
 
+/*
+  A static element has the same denotation in all states of an instance.
+  It is evaluated once per instance and all states share the result.
+*/
+static BooleanDenotations evaluate_static(const Boolean& element, const States& states, DenotationsCaches& caches) {
+    BooleanDenotations denotations;
+    denotations.reserve(states.size());
+    const InstanceInfo* instance_info = nullptr;
+    bool denotation = false;
+    for (const auto& state : states) {
+        if (state.get_instance_info().get() != instance_info) {
+            instance_info = state.get_instance_info().get();
+            denotation = element.evaluate(state, caches);
+        }
+        denotations.push_back(denotation);
+    }
+    return denotations;
+}
+
 const BooleanDenotations* Boolean::evaluate(const States& states, DenotationsCaches& caches) const {
+    DenotationsCaches::EvaluationGuard guard(caches);
     auto cached = caches.get_boolean_denotations_cache().get_denotation(get_index(), -1, -1);
     if (cached) return cached;
-    auto result_denotations = caches.get_boolean_denotations_cache().insert_denotation(evaluate_impl(states, caches));
+    // Denotations of dynamic elements are read from the loaded file if it has all.
+    BooleanDenotations denotations;
+    if (is_static()) {
+        denotations = evaluate_static(*this, states, caches);
+    } else if (!caches.find_stored_denotations(*this, states, denotations)) {
+        denotations = evaluate_impl(states, caches);
+    }
+    auto result_denotations = caches.get_boolean_denotations_cache().insert_denotation(std::move(denotations));
     caches.get_boolean_denotations_cache().insert_denotation(get_index(), -1, -1, result_denotations);
     return result_denotations;
 }
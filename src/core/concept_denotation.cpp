@@ -9,7 +9,7 @@
 namespace dlplan::core {
 
 ConceptDenotation::ConceptDenotation(int num_objects)
-    : m_num_objects(num_objects), m_data(utils::DynamicBitset<unsigned>(num_objects)) { }
+    : m_num_objects(num_objects), m_has_hash(false), m_hash(0), m_data(Bitset(num_objects)) { }
 
 ConceptDenotation::ConceptDenotation(const ConceptDenotation& other) = default;
 
@@ -21,6 +21,10 @@ ConceptDenotation& ConceptDenotation::operator=(ConceptDenotation&& other) = def
 
 ConceptDenotation::~ConceptDenotation() = default;
 
+void ConceptDenotation::invalidate_hash() {
+    m_has_hash = false;
+}
+
 bool ConceptDenotation::operator==(const ConceptDenotation& other) const {
     if (this != &other) {
         return this->m_data == other.m_data;
@@ -34,21 +38,25 @@ bool ConceptDenotation::operator!=(const ConceptDenotation& other) const {
 
 ConceptDenotation& ConceptDenotation::operator&=(const ConceptDenotation& other) {
     m_data &= other.m_data;
+    invalidate_hash();
     return *this;
 }
 
 ConceptDenotation& ConceptDenotation::operator|=(const ConceptDenotation& other) {
     m_data |= other.m_data;
+    invalidate_hash();
     return *this;
 }
 
 ConceptDenotation& ConceptDenotation::operator-=(const ConceptDenotation& other) {
     m_data -= other.m_data;
+    invalidate_hash();
     return *this;
 }
 
 ConceptDenotation& ConceptDenotation::operator~() {
     ~m_data;
+    invalidate_hash();
     return *this;
 }
 
@@ -59,16 +67,24 @@ bool ConceptDenotation::contains(ObjectIndex value) const {
 
 void ConceptDenotation::set() {
     m_data.set();
+    invalidate_hash();
+}
+
+void ConceptDenotation::clear() {
+    m_data.reset();
+    invalidate_hash();
 }
 
 void ConceptDenotation::insert(ObjectIndex value) {
     assert(value >= 0 && value < m_num_objects);
     m_data.set(value);
+    invalidate_hash();
 }
 
 void ConceptDenotation::erase(ObjectIndex value) {
     assert(value >= 0 && value < m_num_objects);
     m_data.reset(value);
+    invalidate_hash();
 }
 
 int ConceptDenotation::size() const {
@@ -83,10 +99,21 @@ bool ConceptDenotation::intersects(const ConceptDenotation& other) const {
     return m_data.intersects(other.m_data);
 }
 
+int ConceptDenotation::intersection_size(const ConceptDenotation& other) const {
+    return m_data.count_intersection(other.m_data);
+}
+
 bool ConceptDenotation::is_subset_of(const ConceptDenotation& other) const {
     return m_data.is_subset_of(other.m_data);
 }
 
+std::size_t ConceptDenotation::compute_memory_usage() const {
+    if (m_data.num_blocks() <= NUM_INLINE_BLOCKS) {
+        return 0;
+    }
+    return m_data.num_blocks() * sizeof(std::uint64_t);
+}
+
 std::string ConceptDenotation::compute_repr() const {
     std::stringstream ss;
     ss << "ConceptDenotation("
@@ -112,18 +139,19 @@ ObjectIndices ConceptDenotation::to_vector() const {
 
 ObjectIndices ConceptDenotation::to_sorted_vector() const {
     ObjectIndices result;
-    result.reserve(m_num_objects);
-    for (ObjectIndex i = 0; i < m_num_objects; ++i) {
-        if (m_data.test(i)) {
-            result.push_back(i);
-        }
+    result.reserve(m_data.count());
+    for (auto pos = m_data.find_first(); pos != m_data.npos; pos = m_data.find_next(pos)) {
+        result.push_back(pos);
     }
-    result.shrink_to_fit();
     return result;
 }
 
 std::size_t ConceptDenotation::hash() const {
-    return m_data.hash();
+    if (!m_has_hash) {
+        m_hash = m_data.hash();
+        m_has_hash = true;
+    }
+    return m_hash;
 }
 
 int ConceptDenotation::get_num_objects() const {
@@ -0,0 +1,152 @@
+#include "../../include/dlplan/core.h"
+
+#include <algorithm>
+#include <cassert>
+
+
+namespace dlplan::core {
+
+using Block = std::uint64_t;
+using Bitset = utils::DynamicBitset<Block>;
+
+static int compute_num_blocks(int num_objects) {
+    return (num_objects + Bitset::bits_per_block - 1) / Bitset::bits_per_block;
+}
+
+static int compute_max_num_blocks(const std::vector<int>& num_objects) {
+    int result = 0;
+    for (int n : num_objects) {
+        result = std::max(result, compute_num_blocks(n));
+    }
+    return result;
+}
+
+static std::vector<int> compute_num_objects(const ConceptDenotations& denotations) {
+    std::vector<int> result;
+    result.reserve(denotations.size());
+    for (const auto* denotation : denotations) {
+        result.push_back(denotation->get_num_objects());
+    }
+    return result;
+}
+
+ConceptDenotationMatrix::ConceptDenotationMatrix(const std::vector<int>& num_objects)
+    : m_num_objects(num_objects),
+      m_num_blocks_per_row(compute_max_num_blocks(num_objects)),
+      m_data(Bitset(num_objects.size() * m_num_blocks_per_row * Bitset::bits_per_block)) { }
+
+ConceptDenotationMatrix::ConceptDenotationMatrix(const ConceptDenotations& denotations)
+    : ConceptDenotationMatrix(compute_num_objects(denotations)) {
+    Block* data = m_data.data();
+    for (std::size_t row = 0; row < denotations.size(); ++row) {
+        const auto& bitset = denotations[row]->m_data;
+        std::copy(bitset.data(), bitset.data() + bitset.num_blocks(), data + row * m_num_blocks_per_row);
+    }
+}
+
+ConceptDenotationMatrix::ConceptDenotationMatrix(const ConceptDenotationMatrix& other) = default;
+
+ConceptDenotationMatrix& ConceptDenotationMatrix::operator=(const ConceptDenotationMatrix& other) = default;
+
+ConceptDenotationMatrix::ConceptDenotationMatrix(ConceptDenotationMatrix&& other) = default;
+
+ConceptDenotationMatrix& ConceptDenotationMatrix::operator=(ConceptDenotationMatrix&& other) = default;
+
+ConceptDenotationMatrix::~ConceptDenotationMatrix() = default;
+
+std::size_t ConceptDenotationMatrix::compute_position(int row, ObjectIndex value) const {
+    assert(row >= 0 && row < get_num_rows());
+    assert(value >= 0 && value < m_num_objects[row]);
+    return static_cast<std::size_t>(row) * m_num_blocks_per_row * Bitset::bits_per_block + value;
+}
+
+void ConceptDenotationMatrix::zero_padding_bits() {
+    Block* data = m_data.data();
+    for (std::size_t row = 0; row < m_num_objects.size(); ++row) {
+        Block* row_data = data + row * m_num_blocks_per_row;
+        int num_blocks = compute_num_blocks(m_num_objects[row]);
+        int num_bits_in_last_block = m_num_objects[row] % Bitset::bits_per_block;
+        if (num_bits_in_last_block != 0) {
+            row_data[num_blocks - 1] &= ~Block(0) >> (Bitset::bits_per_block - num_bits_in_last_block);
+        }
+        std::fill(row_data + num_blocks, row_data + m_num_blocks_per_row, Block(0));
+    }
+}
+
+bool ConceptDenotationMatrix::operator==(const ConceptDenotationMatrix& other) const {
+    if (this != &other) {
+        return m_num_objects == other.m_num_objects && m_data == other.m_data;
+    }
+    return true;
+}
+
+bool ConceptDenotationMatrix::operator!=(const ConceptDenotationMatrix& other) const {
+    return !(*this == other);
+}
+
+ConceptDenotationMatrix& ConceptDenotationMatrix::operator&=(const ConceptDenotationMatrix& other) {
+    assert(m_num_objects == other.m_num_objects);
+    m_data &= other.m_data;
+    return *this;
+}
+
+ConceptDenotationMatrix& ConceptDenotationMatrix::operator|=(const ConceptDenotationMatrix& other) {
+    assert(m_num_objects == other.m_num_objects);
+    m_data |= other.m_data;
+    return *this;
+}
+
+ConceptDenotationMatrix& ConceptDenotationMatrix::operator-=(const ConceptDenotationMatrix& other) {
+    assert(m_num_objects == other.m_num_objects);
+    m_data -= other.m_data;
+    return *this;
+}
+
+ConceptDenotationMatrix& ConceptDenotationMatrix::operator~() {
+    ~m_data;
+    zero_padding_bits();
+    return *this;
+}
+
+bool ConceptDenotationMatrix::contains(int row, ObjectIndex value) const {
+    return m_data.test(compute_position(row, value));
+}
+
+void ConceptDenotationMatrix::insert(int row, ObjectIndex value) {
+    m_data.set(compute_position(row, value));
+}
+
+void ConceptDenotationMatrix::erase(int row, ObjectIndex value) {
+    m_data.reset(compute_position(row, value));
+}
+
+int ConceptDenotationMatrix::size(int row) const {
+    assert(row >= 0 && row < get_num_rows());
+    return m_data.count(static_cast<std::size_t>(row) * m_num_blocks_per_row, m_num_blocks_per_row);
+}
+
+ConceptDenotation ConceptDenotationMatrix::get_denotation(int row) const {
+    assert(row >= 0 && row < get_num_rows());
+    ConceptDenotation result(m_num_objects[row]);
+    const Block* row_data = m_data.data() + static_cast<std::size_t>(row) * m_num_blocks_per_row;
+    std::copy(row_data, row_data + result.m_data.num_blocks(), result.m_data.data());
+    return result;
+}
+
+std::size_t ConceptDenotationMatrix::compute_memory_usage() const {
+    return m_data.num_blocks() * sizeof(Block) + m_num_objects.capacity() * sizeof(int);
+}
+
+std::size_t ConceptDenotationMatrix::hash() const {
+    return m_data.hash();
+}
+
+int ConceptDenotationMatrix::get_num_rows() const {
+    return m_num_objects.size();
+}
+
+int ConceptDenotationMatrix::get_num_objects(int row) const {
+    return m_num_objects[row];
+}
+
+}
@@ -15,18 +15,12 @@ size_t hash_impl<RoleDenotation>::operator()(const RoleDenotation& denotation) c
     return denotation.hash();
 }
 size_t hash_impl<ConceptDenotations>::operator()(const ConceptDenotations& denotations) const {
-    size_t seed = 0;
-    for (const auto denot_ptr : denotations) {
-        dlplan::utils::hash_combine(seed, denot_ptr);
-    }
-    return seed;
+    // Denotations are unique in the cache, hence, we hash the pointers.
+    return dlplan::utils::hash_bytes(denotations.data(), denotations.size() * sizeof(const ConceptDenotation*), 0);
 }
 size_t hash_impl<RoleDenotations>::operator()(const RoleDenotations& denotations) const {
-    size_t seed = 0;
-    for (const auto denot_ptr : denotations) {
-        dlplan::utils::hash_combine(seed, denot_ptr);
-    }
-    return seed;
+    // Denotations are unique in the cache, hence, we hash the pointers.
+    return dlplan::utils::hash_bytes(denotations.data(), denotations.size() * sizeof(const RoleDenotation*), 0);
 }
 size_t hash_impl<bool>::operator()(const bool& value) const {
     return std::hash<bool>()(value);
@@ -1,10 +1,40 @@
+#include "denotations_file.h"
+
 #include "../../include/dlplan/core.h"
 #include "../../include/dlplan/utils/hash.h"
 
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <unordered_set>
+
 
 namespace dlplan::core {
 
-DenotationsCaches::DenotationsCaches() = default;
+DenotationsCaches::DenotationsCaches()
+    : m_memory_limit(std::numeric_limits<std::size_t>::max()), m_num_evaluations(0) { }
+
+static int check_num_shards(int num_shards) {
+    if (num_shards <= 0 || (num_shards & (num_shards - 1)) != 0) {
+        throw std::runtime_error("DenotationsCaches::DenotationsCaches - number of shards must be a power of two.");
+    }
+    return num_shards;
+}
+
+DenotationsCaches::DenotationsCaches(int num_shards)
+    : m_concept_denotation_cache(check_num_shards(num_shards)),
+      m_role_denotation_cache(num_shards),
+      m_boolean_denotation_cache(num_shards),
+      m_numerical_denotation_cache(num_shards),
+      m_concept_denotations_cache(num_shards),
+      m_role_denotations_cache(num_shards),
+      m_boolean_denotations_cache(num_shards),
+      m_numerical_denotations_cache(num_shards),
+      m_memory_limit(std::numeric_limits<std::size_t>::max()),
+      m_num_evaluations(0),
+      m_evaluation_mutex(std::make_unique<std::shared_mutex>()) {
+    m_distances_cache.m_mutex = std::make_unique<std::mutex>();
+}
 
 DenotationsCaches::~DenotationsCaches() = default;
 
@@ -44,6 +74,284 @@ DenotationsCaches::Cache<NumericalDenotations>& DenotationsCaches::get_numerical
     return m_numerical_denotations_cache;
 }
 
+DenotationsCaches::DistancesCache& DenotationsCaches::get_distances_cache() {
+    return m_distances_cache;
+}
+
+void DenotationsCaches::set_memory_limit(std::size_t num_bytes) {
+    m_memory_limit = num_bytes;
+}
+
+std::size_t DenotationsCaches::get_memory_limit() const {
+    return m_memory_limit;
+}
+
+void DenotationsCaches::set_distances_memory_limit(std::size_t num_bytes) {
+    auto lock = m_distances_cache.lock();
+    m_distances_cache.set_memory_limit(num_bytes);
+}
+
+std::size_t DenotationsCaches::get_distances_memory_limit() const {
+    auto lock = m_distances_cache.lock();
+    return m_distances_cache.m_memory_limit;
+}
+
+std::size_t DenotationsCaches::compute_memory_usage() const {
+    std::size_t distances_memory_usage;
+    {
+        auto lock = m_distances_cache.lock();
+        distances_memory_usage = m_distances_cache.m_memory_usage;
+    }
+    return m_concept_denotation_cache.compute_memory_usage()
+        + m_role_denotation_cache.compute_memory_usage()
+        + m_boolean_denotation_cache.compute_memory_usage()
+        + m_numerical_denotation_cache.compute_memory_usage()
+        + m_concept_denotations_cache.compute_memory_usage()
+        + m_role_denotations_cache.compute_memory_usage()
+        + m_boolean_denotations_cache.compute_memory_usage()
+        + m_numerical_denotations_cache.compute_memory_usage()
+        + distances_memory_usage;
+}
+
+bool DenotationsCaches::is_concurrent() const {
+    return m_evaluation_mutex != nullptr;
+}
+
+std::map<std::string, DenotationsCaches::Statistics> DenotationsCaches::get_statistics() const {
+    return {
+        {"concept_denotation", m_concept_denotation_cache.get_statistics()},
+        {"role_denotation", m_role_denotation_cache.get_statistics()},
+        {"boolean_denotation", m_boolean_denotation_cache.get_statistics()},
+        {"numerical_denotation", m_numerical_denotation_cache.get_statistics()},
+        {"concept_denotations", m_concept_denotations_cache.get_statistics()},
+        {"role_denotations", m_role_denotations_cache.get_statistics()},
+        {"boolean_denotations", m_boolean_denotations_cache.get_statistics()},
+        {"numerical_denotations", m_numerical_denotations_cache.get_statistics()}};
+}
+
+void DenotationsCaches::open_state_scope(const State& state) {
+    InstanceIndex instance = state.get_instance_info()->get_index();
+    StateIndex index = state.get_index();
+    m_concept_denotation_cache.open_scope(instance, index);
+    m_role_denotation_cache.open_scope(instance, index);
+    m_boolean_denotation_cache.open_scope(instance, index);
+    m_numerical_denotation_cache.open_scope(instance, index);
+}
+
+void DenotationsCaches::close_state_scope(const State& state) {
+    InstanceIndex instance = state.get_instance_info()->get_index();
+    StateIndex index = state.get_index();
+    auto ignore = [](const auto*) { };
+    m_concept_denotation_cache.close_scope(instance, index, ignore);
+    // Distance matrices are keyed by raw pointers to role denotations.
+    m_role_denotation_cache.close_scope(instance, index, [this](const RoleDenotation* denotation) {
+        auto lock = m_distances_cache.lock();
+        m_distances_cache.erase(denotation);
+    });
+    m_boolean_denotation_cache.close_scope(instance, index, ignore);
+    m_numerical_denotation_cache.close_scope(instance, index, ignore);
+}
+
+/*
+  Each element is written once even if it is a child of several elements.
+  Denotations of static elements are written once per instance. A batched
+  evaluation maps a dynamic element only to the collection of its
+  denotations, whose i-th denotation belongs to the i-th state.
+*/
+void DenotationsCaches::save(const std::string& filename, const std::vector<std::shared_ptr<const BaseElement>>& elements, const States& states) const {
+    std::unordered_map<InstanceIndex, std::uint64_t> fingerprints;
+    std::vector<std::uint64_t> state_fingerprints;
+    state_fingerprints.reserve(states.size());
+    for (const auto& state : states) {
+        const auto& instance = *state.get_instance_info();
+        if (!fingerprints.count(instance.get_index())) {
+            fingerprints.emplace(instance.get_index(), compute_instance_fingerprint(instance));
+        }
+        state_fingerprints.push_back(compute_state_fingerprint(state));
+    }
+    DenotationsFileWriter writer;
+    auto add_denotations = [&](const auto& cache, const auto& collections_cache, const BaseElement& element, DenotationType type) {
+        int record = writer.add_element(element.compute_repr(), type);
+        const auto* collection = element.is_static() ? nullptr : collections_cache.find_denotation(element.get_index(), -1, -1);
+        if (collection && collection->size() != states.size()) {
+            collection = nullptr;
+        }
+        for (std::size_t i = 0; i < states.size(); ++i) {
+            InstanceIndex instance = states[i].get_instance_info()->get_index();
+            StateIndex index = element.is_static() ? -1 : states[i].get_index();
+            std::uint64_t state_fingerprint = element.is_static() ? 0 : state_fingerprints[i];
+            const auto* denotation = cache.find_denotation(element.get_index(), instance, index);
+            if (denotation) {
+                writer.add_denotation(record, fingerprints.at(instance), index, state_fingerprint, *denotation);
+            } else if (collection && index >= 0) {
+                using Value = typename std::decay_t<decltype(*collection)>::value_type;
+                if constexpr (std::is_pointer<Value>::value) {
+                    writer.add_denotation(record, fingerprints.at(instance), index, state_fingerprint, *(*collection)[i]);
+                } else {
+                    writer.add_denotation(record, fingerprints.at(instance), index, state_fingerprint, Value((*collection)[i]));
+                }
+            }
+        }
+    };
+    std::unordered_set<const BaseElement*> visited;
+    std::vector<const BaseElement*> stack;
+    for (const auto& element : elements) {
+        stack.push_back(element.get());
+    }
+    while (!stack.empty()) {
+        const BaseElement* element = stack.back();
+        stack.pop_back();
+        if (!visited.insert(element).second) {
+            continue;
+        }
+        if (dynamic_cast<const Concept*>(element)) {
+            add_denotations(m_concept_denotation_cache, m_concept_denotations_cache, *element, DenotationType::CONCEPT);
+        } else if (dynamic_cast<const Role*>(element)) {
+            add_denotations(m_role_denotation_cache, m_role_denotations_cache, *element, DenotationType::ROLE);
+        } else if (dynamic_cast<const Boolean*>(element)) {
+            add_denotations(m_boolean_denotation_cache, m_boolean_denotations_cache, *element, DenotationType::BOOLEAN);
+        } else if (dynamic_cast<const Numerical*>(element)) {
+            add_denotations(m_numerical_denotation_cache, m_numerical_denotations_cache, *element, DenotationType::NUMERICAL);
+        }
+        for (const BaseElement* child : element->get_children()) {
+            stack.push_back(child);
+        }
+    }
+    writer.write(filename);
+}
+
+void DenotationsCaches::load(const std::string& filename) {
+    m_file = std::make_unique<DenotationsFile>(filename);
+}
+
+/*
+  Stored denotations are interned into the current generation, never into
+  an open scope, because the collection of a batched evaluation points to
+  them and is not released with the scope. The mapping of each state to
+  its stored denotation can be released with the scope.
+*/
+template<typename Cache, typename Denotation, typename Denotations>
+static bool find_stored_denotations(DenotationsCaches& caches, Cache& cache, const BaseElement& element, const States& states, const Denotation& initial, Denotations& result) {
+    result.clear();
+    result.reserve(states.size());
+    for (const auto& state : states) {
+        Denotation denotation(initial);
+        if (state.get_index() < 0 || !caches.find_stored_denotation(element, state, denotation)) {
+            return false;
+        }
+        const Denotation* stored = cache.insert_denotation(std::move(denotation));
+        cache.insert_denotation(element.get_index(), state.get_instance_info()->get_index(), state.get_index(), stored);
+        if constexpr (std::is_pointer<typename Denotations::value_type>::value) {
+            result.push_back(stored);
+        } else {
+            result.push_back(*stored);
+        }
+    }
+    return true;
+}
+
+bool DenotationsCaches::find_stored_denotations(const BaseElement& element, const States& states, ConceptDenotations& result) {
+    return m_file && core::find_stored_denotations(*this, m_concept_denotation_cache, element, states, ConceptDenotation(0), result);
+}
+
+bool DenotationsCaches::find_stored_denotations(const BaseElement& element, const States& states, RoleDenotations& result) {
+    return m_file && core::find_stored_denotations(*this, m_role_denotation_cache, element, states, RoleDenotation(0), result);
+}
+
+bool DenotationsCaches::find_stored_denotations(const BaseElement& element, const States& states, BooleanDenotations& result) {
+    return m_file && core::find_stored_denotations(*this, m_boolean_denotation_cache, element, states, false, result);
+}
+
+bool DenotationsCaches::find_stored_denotations(const BaseElement& element, const States& states, NumericalDenotations& result) {
+    return m_file && core::find_stored_denotations(*this, m_numerical_denotation_cache, element, states, 0, result);
+}
+
+bool DenotationsCaches::find_stored_denotation(const BaseElement& element, const State& state, ConceptDenotation& result) {
+    return m_file && m_file->find_denotation(element, state, result);
+}
+
+bool DenotationsCaches::find_stored_denotation(const BaseElement& element, const State& state, RoleDenotation& result) {
+    return m_file && m_file->find_denotation(element, state, result);
+}
+
+bool DenotationsCaches::find_stored_denotation(const BaseElement& element, const State& state, bool& result) {
+    return m_file && m_file->find_denotation(element, state, result);
+}
+
+bool DenotationsCaches::find_stored_denotation(const BaseElement& element, const State& state, int& result) {
+    return m_file && m_file->find_denotation(element, state, result);
+}
+
+
+/*
+  Collections of denotations point to single denotations of the generation
+  in which they were inserted. A copy into the current generation would
+  keep these pointers, so collections are discarded entirely instead. The
+  same holds for distance matrices, which are keyed by raw pointers to
+  role denotations.
+*/
+void DenotationsCaches::evict_if_over_memory_limit() {
+    if (compute_memory_usage() <= m_memory_limit) {
+        return;
+    }
+    m_concept_denotation_cache.evict();
+    m_role_denotation_cache.evict();
+    m_boolean_denotation_cache.evict();
+    m_numerical_denotation_cache.evict();
+    m_concept_denotations_cache.clear();
+    m_role_denotations_cache.clear();
+    m_boolean_denotations_cache.clear();
+    m_numerical_denotations_cache.clear();
+    auto lock = m_distances_cache.lock();
+    m_distances_cache.clear();
+}
+
+
+// Concurrent caches that the calling thread evaluates with, if any.
+static thread_local const DenotationsCaches* t_caches = nullptr;
+
+/*
+  With concurrent caches, an evaluation is top-level if the calling thread
+  does not already evaluate with the caches. Top-level evaluations hold the
+  evaluation mutex shared, such that eviction waits until all threads have
+  left their evaluations. Nested evaluations neither lock nor evict.
+*/
+DenotationsCaches::EvaluationGuard::EvaluationGuard(DenotationsCaches& caches)
+    : m_caches(caches), m_previous_caches(nullptr) {
+    if (!m_caches.m_evaluation_mutex) {
+        if (m_caches.m_num_evaluations == 0) {
+            m_caches.evict_if_over_memory_limit();
+        }
+        ++m_caches.m_num_evaluations;
+        return;
+    }
+    if (t_caches == &m_caches) {
+        m_previous_caches = &m_caches;
+        return;
+    }
+    if (m_caches.m_memory_limit != std::numeric_limits<std::size_t>::max()
+        && m_caches.compute_memory_usage() > m_caches.m_memory_limit) {
+        std::unique_lock<std::shared_mutex> lock(*m_caches.m_evaluation_mutex);
+        // Another thread may have evicted while this one was waiting.
+        m_caches.evict_if_over_memory_limit();
+    }
+    m_caches.m_evaluation_mutex->lock_shared();
+    m_previous_caches = t_caches;
+    t_caches = &m_caches;
+}
+
+DenotationsCaches::EvaluationGuard::~EvaluationGuard() {
+    if (!m_caches.m_evaluation_mutex) {
+        --m_caches.m_num_evaluations;
+        return;
+    }
+    if (m_previous_caches == &m_caches) {
+        return;
+    }
+    t_caches = m_previous_caches;
+    m_caches.m_evaluation_mutex->unlock_shared();
+}
+
 
 bool DenotationsCaches::Key::operator==(const Key& other) const {
     return (element == other.element) &&
@@ -0,0 +1,342 @@
+#include "denotations_file.h"
+
+#include "../../include/dlplan/utils/dynamic_bitset.h"
+#include "../../include/dlplan/utils/hash.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <tuple>
+
+
+namespace dlplan::core {
+
+static const char DENOTATIONS_FILE_MAGIC[8] = {'D', 'L', 'P', 'D', 'E', 'N', 'O', 'T'};
+static const std::uint32_t DENOTATIONS_FILE_VERSION = 2;
+
+static_assert(sizeof(DenotationsFileHeader) == 64, "DenotationsFileHeader must not contain padding.");
+static_assert(sizeof(ElementRecord) == 40, "ElementRecord must not contain padding.");
+static_assert(sizeof(EntryRecord) == 24, "EntryRecord must not contain padding.");
+static_assert(sizeof(ConceptRecord) == 16, "ConceptRecord must not contain padding.");
+static_assert(sizeof(RoleRecord) == 16, "RoleRecord must not contain padding.");
+
+static std::uint64_t compute_repr_hash(const char* data, std::size_t size) {
+    return dlplan::utils::hash_bytes(data, size, 0);
+}
+
+static std::size_t align_to_8(std::size_t num_bytes) {
+    return (num_bytes + 7) & ~static_cast<std::size_t>(7);
+}
+
+std::uint64_t compute_instance_fingerprint(const InstanceInfo& instance) {
+    std::stringstream ss;
+    for (const auto& object : instance.get_objects()) ss << object.get_name() << ",";
+    ss << ";";
+    for (const auto& atom : instance.get_atoms()) ss << atom.get_name() << ",";
+    ss << ";";
+    for (const auto& atom : instance.get_static_atoms()) ss << atom.get_name() << ",";
+    std::string data = ss.str();
+    return dlplan::utils::hash_bytes(data.data(), data.size(), 0);
+}
+
+std::uint64_t compute_state_fingerprint(const State& state) {
+    AtomIndices atom_indices = state.get_atom_indices();
+    std::sort(atom_indices.begin(), atom_indices.end());
+    return dlplan::utils::hash_bytes(atom_indices.data(), atom_indices.size() * sizeof(int), 0);
+}
+
+
+int DenotationsFileWriter::add_element(const std::string& repr, DenotationType type) {
+    m_elements.push_back(Element{repr, type, {}});
+    return static_cast<int>(m_elements.size()) - 1;
+}
+
+void DenotationsFileWriter::add_denotation(int element, std::uint64_t fingerprint, StateIndex state, std::uint64_t state_fingerprint, const ConceptDenotation& denotation) {
+    std::vector<std::uint64_t> blocks((denotation.get_num_objects() + 63) / 64, 0);
+    denotation.for_each([&](ObjectIndex object) {
+        blocks[object / 64] |= std::uint64_t(1) << (object % 64);
+    });
+    std::string key(reinterpret_cast<const char*>(blocks.data()), blocks.size() * sizeof(std::uint64_t));
+    key += std::to_string(denotation.get_num_objects());
+    auto result = m_concept_indices.emplace(key, m_concepts.size());
+    if (result.second) {
+        m_concepts.push_back(ConceptRecord{m_blocks.size(), static_cast<std::uint32_t>(denotation.get_num_objects()), static_cast<std::uint32_t>(blocks.size())});
+        m_blocks.insert(m_blocks.end(), blocks.begin(), blocks.end());
+    }
+    m_elements[element].entries.push_back(EntryRecord{fingerprint, state_fingerprint, state, result.first->second});
+}
+
+void DenotationsFileWriter::add_denotation(int element, std::uint64_t fingerprint, StateIndex state, std::uint64_t state_fingerprint, const RoleDenotation& denotation) {
+    std::vector<std::int32_t> pairs;
+    pairs.reserve(2 * denotation.size());
+    denotation.for_each([&](ObjectIndex source, ObjectIndex target) {
+        pairs.push_back(source);
+        pairs.push_back(target);
+    });
+    std::string key(reinterpret_cast<const char*>(pairs.data()), pairs.size() * sizeof(std::int32_t));
+    key += std::to_string(denotation.get_num_objects());
+    auto result = m_role_indices.emplace(key, m_roles.size());
+    if (result.second) {
+        m_roles.push_back(RoleRecord{m_pairs.size() / 2, static_cast<std::uint32_t>(denotation.get_num_objects()), static_cast<std::uint32_t>(pairs.size() / 2)});
+        m_pairs.insert(m_pairs.end(), pairs.begin(), pairs.end());
+    }
+    m_elements[element].entries.push_back(EntryRecord{fingerprint, state_fingerprint, state, result.first->second});
+}
+
+void DenotationsFileWriter::add_denotation(int element, std::uint64_t fingerprint, StateIndex state, std::uint64_t state_fingerprint, bool denotation) {
+    m_elements[element].entries.push_back(EntryRecord{fingerprint, state_fingerprint, state, denotation});
+}
+
+void DenotationsFileWriter::add_denotation(int element, std::uint64_t fingerprint, StateIndex state, std::uint64_t state_fingerprint, int denotation) {
+    m_elements[element].entries.push_back(EntryRecord{fingerprint, state_fingerprint, state, static_cast<std::uint32_t>(denotation)});
+}
+
+void DenotationsFileWriter::write(const std::string& filename) {
+    std::vector<ElementRecord> elements;
+    std::vector<EntryRecord> entries;
+    std::string reprs;
+    for (auto& element : m_elements) {
+        std::sort(element.entries.begin(), element.entries.end(), [](const EntryRecord& left, const EntryRecord& right) {
+            return std::tie(left.fingerprint, left.state) < std::tie(right.fingerprint, right.state);
+        });
+        // Static elements have a single entry for all states of an instance.
+        element.entries.erase(std::unique(element.entries.begin(), element.entries.end(), [](const EntryRecord& left, const EntryRecord& right) {
+            return left.fingerprint == right.fingerprint && left.state == right.state;
+        }), element.entries.end());
+        elements.push_back(ElementRecord{
+            compute_repr_hash(element.repr.data(), element.repr.size()), reprs.size(),
+            entries.size(), entries.size() + element.entries.size(),
+            static_cast<std::uint32_t>(element.repr.size()), element.type});
+        entries.insert(entries.end(), element.entries.begin(), element.entries.end());
+        reprs += element.repr;
+    }
+    std::sort(elements.begin(), elements.end(), [&](const ElementRecord& left, const ElementRecord& right) {
+        if (left.repr_hash != right.repr_hash) return left.repr_hash < right.repr_hash;
+        return reprs.compare(left.repr_begin, left.repr_size, reprs, right.repr_begin, right.repr_size) < 0;
+    });
+
+    DenotationsFileHeader header;
+    std::memcpy(header.magic, DENOTATIONS_FILE_MAGIC, sizeof(header.magic));
+    header.version = DENOTATIONS_FILE_VERSION;
+    header.num_elements = elements.size();
+    header.num_entries = entries.size();
+    header.num_concepts = m_concepts.size();
+    header.num_roles = m_roles.size();
+    header.num_blocks = m_blocks.size();
+    header.num_pairs = m_pairs.size() / 2;
+    header.num_repr_bytes = reprs.size();
+
+    std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        throw std::runtime_error("DenotationsFileWriter::write - cannot open " + filename + ".");
+    }
+    auto write_section = [&](const void* data, std::size_t num_bytes) {
+        file.write(static_cast<const char*>(data), num_bytes);
+        static const char padding[8] = {};
+        file.write(padding, align_to_8(num_bytes) - num_bytes);
+    };
+    write_section(&header, sizeof(header));
+    write_section(elements.data(), elements.size() * sizeof(ElementRecord));
+    write_section(entries.data(), entries.size() * sizeof(EntryRecord));
+    write_section(m_concepts.data(), m_concepts.size() * sizeof(ConceptRecord));
+    write_section(m_roles.data(), m_roles.size() * sizeof(RoleRecord));
+    write_section(m_blocks.data(), m_blocks.size() * sizeof(std::uint64_t));
+    write_section(m_pairs.data(), m_pairs.size() * sizeof(std::int32_t));
+    write_section(reprs.data(), reprs.size());
+    if (!file) {
+        throw std::runtime_error("DenotationsFileWriter::write - cannot write " + filename + ".");
+    }
+}
+
+
+DenotationsFile::DenotationsFile(const std::string& filename)
+    : m_file(filename) {
+    const char* data = m_file.data();
+    if (m_file.size() < sizeof(DenotationsFileHeader)
+        || std::memcmp(data, DENOTATIONS_FILE_MAGIC, sizeof(DENOTATIONS_FILE_MAGIC)) != 0) {
+        throw std::runtime_error("DenotationsFile::DenotationsFile - " + filename + " is not a denotations file.");
+    }
+    m_header = reinterpret_cast<const DenotationsFileHeader*>(data);
+    if (m_header->version != DENOTATIONS_FILE_VERSION) {
+        throw std::runtime_error("DenotationsFile::DenotationsFile - " + filename + " has an unsupported version.");
+    }
+    // Sections are located by their sizes, which must fit into the file.
+    // Counts are compared with the file size first, so products cannot overflow.
+    std::size_t offset = 0;
+    auto next_section = [&](std::uint64_t count, std::size_t record_size) {
+        if (count > m_file.size() / record_size || offset > m_file.size()) {
+            throw std::runtime_error("DenotationsFile::DenotationsFile - " + filename + " is truncated.");
+        }
+        const char* section = data + offset;
+        offset += align_to_8(count * record_size);
+        return section;
+    };
+    next_section(1, sizeof(DenotationsFileHeader));
+    m_elements = reinterpret_cast<const ElementRecord*>(next_section(m_header->num_elements, sizeof(ElementRecord)));
+    m_entries = reinterpret_cast<const EntryRecord*>(next_section(m_header->num_entries, sizeof(EntryRecord)));
+    m_concepts = reinterpret_cast<const ConceptRecord*>(next_section(m_header->num_concepts, sizeof(ConceptRecord)));
+    m_roles = reinterpret_cast<const RoleRecord*>(next_section(m_header->num_roles, sizeof(RoleRecord)));
+    m_blocks = reinterpret_cast<const std::uint64_t*>(next_section(m_header->num_blocks, sizeof(std::uint64_t)));
+    m_pairs = reinterpret_cast<const std::int32_t*>(next_section(m_header->num_pairs, 2 * sizeof(std::int32_t)));
+    m_reprs = next_section(m_header->num_repr_bytes, 1);
+    if (offset > m_file.size()) {
+        throw std::runtime_error("DenotationsFile::DenotationsFile - " + filename + " is truncated.");
+    }
+    validate_records(filename);
+}
+
+/*
+  Each index that a lookup reads from the file must lie within its section.
+  Entry ranges of the elements cannot cover more entries than there are,
+  such that the validation takes time linear in the size of the records.
+*/
+void DenotationsFile::validate_records(const std::string& filename) const {
+    auto check = [&](bool condition) {
+        if (!condition) {
+            throw std::runtime_error("DenotationsFile::DenotationsFile - " + filename + " is corrupt.");
+        }
+    };
+    std::uint64_t num_covered_entries = 0;
+    for (std::uint64_t i = 0; i < m_header->num_elements; ++i) {
+        const ElementRecord& element = m_elements[i];
+        check(static_cast<std::uint32_t>(element.type) <= static_cast<std::uint32_t>(DenotationType::NUMERICAL));
+        check(element.repr_begin <= m_header->num_repr_bytes && element.repr_size <= m_header->num_repr_bytes - element.repr_begin);
+        check(element.entries_begin <= element.entries_end && element.entries_end <= m_header->num_entries);
+        num_covered_entries += element.entries_end - element.entries_begin;
+        check(num_covered_entries <= m_header->num_entries);
+        if (element.type == DenotationType::CONCEPT || element.type == DenotationType::ROLE) {
+            std::uint64_t num_denotations = (element.type == DenotationType::CONCEPT) ? m_header->num_concepts : m_header->num_roles;
+            for (std::uint64_t j = element.entries_begin; j < element.entries_end; ++j) {
+                check(m_entries[j].value < num_denotations);
+            }
+        }
+    }
+    for (std::uint64_t i = 0; i < m_header->num_concepts; ++i) {
+        const ConceptRecord& record = m_concepts[i];
+        check(record.blocks_begin <= m_header->num_blocks && record.num_blocks <= m_header->num_blocks - record.blocks_begin);
+        check(record.num_blocks == (static_cast<std::uint64_t>(record.num_objects) + 63) / 64);
+    }
+    for (std::uint64_t i = 0; i < m_header->num_roles; ++i) {
+        const RoleRecord& record = m_roles[i];
+        check(record.pairs_begin <= m_header->num_pairs && record.num_pairs <= m_header->num_pairs - record.pairs_begin);
+    }
+}
+
+const EntryRecord* DenotationsFile::find_entry(const BaseElement& element, const State& state, DenotationType type) {
+    std::lock_guard<std::mutex> hold(m_mutex);
+    auto& element_records = m_element_records[static_cast<int>(type)];
+    auto element_iter = element_records.find(element.get_index());
+    if (element_iter == element_records.end()) {
+        std::string repr = element.compute_repr();
+        std::uint64_t repr_hash = compute_repr_hash(repr.data(), repr.size());
+        const ElementRecord* end = m_elements + m_header->num_elements;
+        int record = -1;
+        for (const ElementRecord* it = std::lower_bound(m_elements, end, repr_hash,
+                [](const ElementRecord& left, std::uint64_t right) { return left.repr_hash < right; });
+             it != end && it->repr_hash == repr_hash; ++it) {
+            if (it->type == type && repr.compare(0, repr.size(), m_reprs + it->repr_begin, it->repr_size) == 0) {
+                record = static_cast<int>(it - m_elements);
+                break;
+            }
+        }
+        element_iter = element_records.emplace(element.get_index(), record).first;
+    }
+    if (element_iter->second < 0) {
+        return nullptr;
+    }
+    const ElementRecord& record = m_elements[element_iter->second];
+    InstanceIndex instance = state.get_instance_info()->get_index();
+    auto fingerprint_iter = m_fingerprints.find(instance);
+    if (fingerprint_iter == m_fingerprints.end()) {
+        fingerprint_iter = m_fingerprints.emplace(instance, compute_instance_fingerprint(*state.get_instance_info())).first;
+    }
+    EntryRecord key{fingerprint_iter->second, 0, element.is_static() ? -1 : state.get_index(), 0};
+    const EntryRecord* begin = m_entries + record.entries_begin;
+    const EntryRecord* end = m_entries + record.entries_end;
+    const EntryRecord* it = std::lower_bound(begin, end, key, [](const EntryRecord& left, const EntryRecord& right) {
+        return std::tie(left.fingerprint, left.state) < std::tie(right.fingerprint, right.state);
+    });
+    if (it == end || it->fingerprint != key.fingerprint || it->state != key.state) {
+        return nullptr;
+    }
+    if (key.state != -1) {
+        std::uint64_t state_key = (static_cast<std::uint64_t>(static_cast<std::uint32_t>(instance)) << 32) | static_cast<std::uint32_t>(key.state);
+        auto state_iter = m_state_fingerprints.find(state_key);
+        if (state_iter == m_state_fingerprints.end()) {
+            state_iter = m_state_fingerprints.emplace(state_key, compute_state_fingerprint(state)).first;
+        }
+        // The state index of a previous run can denote another state.
+        if (it->state_fingerprint != state_iter->second) {
+            return nullptr;
+        }
+    }
+    return it;
+}
+
+bool DenotationsFile::find_denotation(const BaseElement& element, const State& state, ConceptDenotation& result) {
+    const EntryRecord* entry = find_entry(element, state, DenotationType::CONCEPT);
+    if (!entry) {
+        return false;
+    }
+    const ConceptRecord& record = m_concepts[entry->value];
+    const std::uint64_t* blocks = m_blocks + record.blocks_begin;
+    std::uint32_t num_unused_bits = record.num_blocks * 64 - record.num_objects;
+    if (record.num_objects != state.get_instance_info()->get_objects().size()
+        || (num_unused_bits > 0 && (blocks[record.num_blocks - 1] >> (64 - num_unused_bits)) != 0)) {
+        throw std::runtime_error("DenotationsFile::find_denotation - stored concept denotation does not fit the instance.");
+    }
+    result = ConceptDenotation(record.num_objects);
+    for (std::uint32_t i = 0; i < record.num_blocks; ++i) {
+        for (std::uint64_t block = blocks[i]; block; block &= block - 1) {
+            result.insert(i * 64 + dlplan::utils::bitset_detail::count_trailing_zeros(block));
+        }
+    }
+    return true;
+}
+
+bool DenotationsFile::find_denotation(const BaseElement& element, const State& state, RoleDenotation& result) {
+    const EntryRecord* entry = find_entry(element, state, DenotationType::ROLE);
+    if (!entry) {
+        return false;
+    }
+    const RoleRecord& record = m_roles[entry->value];
+    if (record.num_objects != state.get_instance_info()->get_objects().size()) {
+        throw std::runtime_error("DenotationsFile::find_denotation - stored role denotation does not fit the instance.");
+    }
+    result = RoleDenotation(record.num_objects);
+    const std::int32_t* pairs = m_pairs + 2 * record.pairs_begin;
+    for (std::uint32_t i = 0; i < record.num_pairs; ++i) {
+        if (pairs[2 * i] < 0 || pairs[2 * i] >= static_cast<int>(record.num_objects)
+            || pairs[2 * i + 1] < 0 || pairs[2 * i + 1] >= static_cast<int>(record.num_objects)) {
+            throw std::runtime_error("DenotationsFile::find_denotation - stored role denotation does not fit the instance.");
+        }
+        result.insert(std::make_pair(pairs[2 * i], pairs[2 * i + 1]));
+    }
+    return true;
+}
+
+bool DenotationsFile::find_denotation(const BaseElement& element, const State& state, bool& result) {
+    const EntryRecord* entry = find_entry(element, state, DenotationType::BOOLEAN);
+    if (!entry) {
+        return false;
+    }
+    result = entry->value;
+    return true;
+}
+
+bool DenotationsFile::find_denotation(const BaseElement& element, const State& state, int& result) {
+    const EntryRecord* entry = find_entry(element, state, DenotationType::NUMERICAL);
+    if (!entry) {
+        return false;
+    }
+    result = static_cast<int>(entry->value);
+    return true;
+}
+
+std::size_t DenotationsFile::get_num_entries() const {
+    return m_header->num_entries;
+}
+
+}
@@ -0,0 +1,168 @@
+#ifndef DLPLAN_SRC_CORE_DENOTATIONS_FILE_H_
+#define DLPLAN_SRC_CORE_DENOTATIONS_FILE_H_
+
+#include "../utils/memory_mapped_file.h"
+
+#include "../../include/dlplan/core.h"
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+
+/*
+  Binary file of denotations with the following sections, each aligned to
+  8 bytes, in native byte order:
+
+    Header
+    ElementRecord[num_elements]   sorted by hash and repr of the element
+    EntryRecord[num_entries]      sorted by fingerprint and state per element
+    ConceptRecord[num_concepts]   unique concept denotations
+    RoleRecord[num_roles]         unique role denotations
+    uint64_t[num_blocks]          bitsets of the concept denotations
+    int32_t[2 * num_pairs]        pairs of the role denotations
+    char[num_repr_bytes]          reprs of the elements
+
+  An entry maps the fingerprint of an instance and a state index, which is -1
+  for static elements, to the index of a concept or role denotation or to the
+  value of a boolean or numerical. Elements are identified by their repr
+  because element indices depend on the order in which they are created.
+  Entries also store a fingerprint of the atoms of their state, such that a
+  run that numbers its states differently does not find stale denotations.
+*/
+namespace dlplan::core {
+
+enum class DenotationType : std::uint32_t { CONCEPT, ROLE, BOOLEAN, NUMERICAL };
+
+struct DenotationsFileHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t num_elements;
+    std::uint64_t num_entries;
+    std::uint64_t num_concepts;
+    std::uint64_t num_roles;
+    std::uint64_t num_blocks;
+    std::uint64_t num_pairs;
+    std::uint64_t num_repr_bytes;
+};
+
+struct ElementRecord {
+    std::uint64_t repr_hash;
+    std::uint64_t repr_begin;
+    std::uint64_t entries_begin;
+    std::uint64_t entries_end;
+    std::uint32_t repr_size;
+    DenotationType type;
+};
+
+struct EntryRecord {
+    std::uint64_t fingerprint;
+    std::uint64_t state_fingerprint;
+    std::int32_t state;
+    std::uint32_t value;
+};
+
+struct ConceptRecord {
+    std::uint64_t blocks_begin;
+    std::uint32_t num_objects;
+    std::uint32_t num_blocks;
+};
+
+struct RoleRecord {
+    std::uint64_t pairs_begin;
+    std::uint32_t num_objects;
+    std::uint32_t num_pairs;
+};
+
+/// @brief Returns a hash value of the objects and atoms of the instance,
+///        which identifies it across runs independently of its index.
+extern std::uint64_t compute_instance_fingerprint(const InstanceInfo& instance);
+/// @brief Returns a hash value of the sorted atom indices of the state.
+extern std::uint64_t compute_state_fingerprint(const State& state);
+
+
+/// @brief Collects denotations of elements and writes them to a file.
+class DenotationsFileWriter {
+private:
+    struct Element {
+        std::string repr;
+        DenotationType type;
+        std::vector<EntryRecord> entries;
+    };
+
+    std::vector<Element> m_elements;
+    std::vector<ConceptRecord> m_concepts;
+    std::vector<RoleRecord> m_roles;
+    std::vector<std::uint64_t> m_blocks;
+    std::vector<std::int32_t> m_pairs;
+    // Concept and role denotations are interned by their repr.
+    std::unordered_map<std::string, std::uint32_t> m_concept_indices;
+    std::unordered_map<std::string, std::uint32_t> m_role_indices;
+
+public:
+    /// @brief Adds an element and returns its index in the writer.
+    int add_element(const std::string& repr, DenotationType type);
+
+    /// @brief Adds the denotation of the element in a state, whose fingerprint
+    ///        is zero if the element is static, i.e., state is -1.
+    void add_denotation(int element, std::uint64_t fingerprint, StateIndex state, std::uint64_t state_fingerprint, const ConceptDenotation& denotation);
+    void add_denotation(int element, std::uint64_t fingerprint, StateIndex state, std::uint64_t state_fingerprint, const RoleDenotation& denotation);
+    void add_denotation(int element, std::uint64_t fingerprint, StateIndex state, std::uint64_t state_fingerprint, bool denotation);
+    void add_denotation(int element, std::uint64_t fingerprint, StateIndex state, std::uint64_t state_fingerprint, int denotation);
+
+    /// @brief Writes all denotations and throws std::runtime_error on failure.
+    void write(const std::string& filename);
+};
+
+
+/// @brief Looks up denotations in a memory-mapped file. Opening the file
+///        validates its records in time linear in their number, such that
+///        lookups stay within the mapping. Denotations are constructed when
+///        they are looked up.
+class DenotationsFile {
+private:
+    dlplan::utils::MemoryMappedFile m_file;
+    const DenotationsFileHeader* m_header;
+    const ElementRecord* m_elements;
+    const EntryRecord* m_entries;
+    const ConceptRecord* m_concepts;
+    const RoleRecord* m_roles;
+    const std::uint64_t* m_blocks;
+    const std::int32_t* m_pairs;
+    const char* m_reprs;
+
+    // Record of each element index per type, because each type has its own
+    // indices, or -1 if the element is not in the file, and fingerprints of
+    // each instance index and each state index per instance, all computed
+    // on first use.
+    std::unordered_map<ElementIndex, int> m_element_records[4];
+    std::unordered_map<InstanceIndex, std::uint64_t> m_fingerprints;
+    std::unordered_map<std::uint64_t, std::uint64_t> m_state_fingerprints;
+    // Threads can look up denotations with concurrent caches.
+    std::mutex m_mutex;
+
+    /// @brief Throws std::runtime_error if an index in a record is out of bounds.
+    void validate_records(const std::string& filename) const;
+
+    /// @brief Returns the entry of the element in the state or nullptr.
+    const EntryRecord* find_entry(const BaseElement& element, const State& state, DenotationType type);
+
+public:
+    /// @brief Maps the file and throws std::runtime_error if it is not a valid
+    ///        denotations file. Lookups throw std::runtime_error if a stored
+    ///        denotation does not fit the objects of the instance.
+    explicit DenotationsFile(const std::string& filename);
+
+    bool find_denotation(const BaseElement& element, const State& state, ConceptDenotation& result);
+    bool find_denotation(const BaseElement& element, const State& state, RoleDenotation& result);
+    bool find_denotation(const BaseElement& element, const State& state, bool& result);
+    bool find_denotation(const BaseElement& element, const State& state, int& result);
+
+    std::size_t get_num_entries() const;
+};
+
+}
+
+#endif
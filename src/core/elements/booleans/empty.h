@@ -43,6 +43,12 @@ private:
         return denotations;
     }
 
+    bool evaluate_impl(const State&, const EvaluationOperands& operands) const override {
+        bool denotation;
+        compute_result(operands.get_denotation(*m_element), denotation);
+        return denotation;
+    }
+
 protected:
     const std::shared_ptr<const T> m_element;
 
@@ -52,9 +58,12 @@ public:
     }
 
     bool evaluate(const State& state) const override {
-        bool denotation;
-        compute_result(m_element->evaluate(state), denotation);
-        return denotation;
+        // Stops at the first witness.
+        return m_element->for_each(state, [](const auto&) { return false; });
+    }
+
+    std::vector<const BaseElement*> get_children() const override {
+        return {m_element.get()};
     }
 
     int compute_complexity() const override {
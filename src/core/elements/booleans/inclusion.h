@@ -47,6 +47,15 @@ private:
         return denotations;
     }
 
+    bool evaluate_impl(const State&, const EvaluationOperands& operands) const override {
+        bool denotation;
+        compute_result(
+            operands.get_denotation(*m_element_left),
+            operands.get_denotation(*m_element_right),
+            denotation);
+        return denotation;
+    }
+
 protected:
     const std::shared_ptr<const T> m_element_left;
     const std::shared_ptr<const T> m_element_right;
@@ -59,12 +68,15 @@ public:
     }
 
     bool evaluate(const State& state) const override {
-        bool denotation;
-        compute_result(
-            m_element_left->evaluate(state),
-            m_element_right->evaluate(state),
-            denotation);
-        return denotation;
+        // Stops at the first counterexample.
+        const auto right_denot = m_element_right->evaluate(state);
+        return m_element_left->for_each(state, [&](const auto& value) {
+            return right_denot.contains(value);
+        });
+    }
+
+    std::vector<const BaseElement*> get_children() const override {
+        return {m_element_left.get(), m_element_right.get()};
     }
 
     int compute_complexity() const override {
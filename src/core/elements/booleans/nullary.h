@@ -15,21 +15,8 @@ namespace dlplan::core {
 class NullaryBoolean : public Boolean {
 private:
     void compute_result(const State& state, bool& result) const {
-        const auto& atoms = state.get_instance_info()->get_atoms();
-        for (int atom_idx : state.get_atom_indices()) {
-            const auto& atom = atoms[atom_idx];
-            if (atom.get_predicate_index() == m_predicate.get_index()) {
-                result = true;
-                return;
-            }
-        }
-        for (const auto &atom : state.get_instance_info()->get_static_atoms()) {
-            if (atom.get_predicate_index() == m_predicate.get_index()) {
-                result = true;
-                return;
-            }
-        }
-        result = false;
+        result = !state.get_atom_indices(m_predicate.get_index()).empty()
+            || !state.get_instance_info()->get_static_atom_indices(m_predicate.get_index()).empty();
     }
 
     bool evaluate_impl(const State& state, DenotationsCaches&) const override {
@@ -45,6 +32,12 @@ private:
         return denotations;
     }
 
+    bool evaluate_impl(const State& state, const EvaluationOperands&) const override {
+        bool denotation;
+        compute_result(state, denotation);
+        return denotation;
+    }
+
 protected:
     const Predicate m_predicate;
 
@@ -62,6 +55,10 @@ public:
         return denotation;
     }
 
+    std::vector<const BaseElement*> get_children() const override {
+        return {};
+    }
+
     int compute_complexity() const override {
         return 1;
     }
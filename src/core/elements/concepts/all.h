@@ -16,10 +16,9 @@ class AllConcept : public Concept {
 private:
     void compute_result(const RoleDenotation& role_denot, const ConceptDenotation& concept_denot, ConceptDenotation& result) const {
         // find counterexamples b : exists b . (a,b) in R and b notin C
-        result.set();
-        for (const auto& pair : role_denot.to_vector()) {
-            if (!concept_denot.contains(pair.second)) {
-                result.erase(pair.first);
+        for (int i = 0; i < role_denot.get_num_objects(); ++i) {
+            if (role_denot.successors_are_subset_of(i, concept_denot)) {
+                result.insert(i);
             }
         }
     }
@@ -49,6 +48,13 @@ private:
         return denotations;
     }
 
+    void evaluate_impl(const State&, const EvaluationOperands& operands, ConceptDenotation& denotation) const override {
+        compute_result(
+            operands.get_denotation(*m_role),
+            operands.get_denotation(*m_concept),
+            denotation);
+    }
+
 protected:
     const std::shared_ptr<const Role> m_role;
     const std::shared_ptr<const Concept> m_concept;
@@ -70,6 +76,10 @@ public:
         return denotation;
     }
 
+    std::vector<const BaseElement*> get_children() const override {
+        return {m_role.get(), m_concept.get()};
+    }
+
     int compute_complexity() const override {
         return m_role->compute_complexity() + m_concept->compute_complexity() + 1;
     }
@@ -28,6 +28,8 @@ private:
         return denotations;
     }
 
+    void evaluate_impl(const State&, const EvaluationOperands&, ConceptDenotation&) const override { }
+
 public:
     BotConcept(std::shared_ptr<const VocabularyInfo> vocabulary_info)
     : Concept(vocabulary_info, true) { }
@@ -36,6 +38,10 @@ public:
         return ConceptDenotation(state.get_instance_info()->get_objects().size());
     }
 
+    std::vector<const BaseElement*> get_children() const override {
+        return {};
+    }
+
     int compute_complexity() const override {
         return 1;
     }
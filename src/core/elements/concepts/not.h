@@ -42,6 +42,12 @@ private:
         return denotations;
     }
 
+    void evaluate_impl(const State&, const EvaluationOperands& operands, ConceptDenotation& denotation) const override {
+        compute_result(
+            operands.get_denotation(*m_concept),
+            denotation);
+    }
+
 protected:
     const std::shared_ptr<const Concept> m_concept;
 
@@ -61,6 +67,10 @@ public:
         return denotation;
     }
 
+    std::vector<const BaseElement*> get_children() const override {
+        return {m_concept.get()};
+    }
+
     int compute_complexity() const override {
         return m_concept->compute_complexity() + 1;
     }
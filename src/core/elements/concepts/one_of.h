@@ -49,6 +49,10 @@ private:
         return denotations;
     }
 
+    void evaluate_impl(const State& state, const EvaluationOperands&, ConceptDenotation& result) const override {
+        compute_result(state, result);
+    }
+
 protected:
     const Constant m_constant;
 
@@ -63,6 +67,10 @@ public:
         return result;
     }
 
+    std::vector<const BaseElement*> get_children() const override {
+        return {};
+    }
+
     int compute_complexity() const override {
         return 1;
     }
@@ -45,6 +45,13 @@ private:
         return denotations;
     }
 
+    void evaluate_impl(const State&, const EvaluationOperands& operands, ConceptDenotation& result) const override {
+        compute_result(
+            operands.get_denotation(*m_concept_left),
+            operands.get_denotation(*m_concept_right),
+            result);
+    }
+
 protected:
     std::shared_ptr<const Concept> m_concept_left;
     std::shared_ptr<const Concept> m_concept_right;
@@ -73,6 +80,14 @@ public:
         return result;
     }
 
+    std::vector<const BaseElement*> get_children() const override {
+        return {m_concept_left.get(), m_concept_right.get()};
+    }
+
+    bool for_each(const State& state, const std::function<bool(ObjectIndex)>& function) const override {
+        return m_concept_left->for_each(state, function) && m_concept_right->for_each(state, function);
+    }
+
     int compute_complexity() const override {
         return m_concept_left->compute_complexity() + m_concept_right->compute_complexity() + 1;
     }
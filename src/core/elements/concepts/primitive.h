@@ -16,22 +16,29 @@ namespace dlplan::core {
 
 class PrimitiveConcept : public Concept {
 private:
-    void compute_result(const State& state, ConceptDenotation& result) const {
+    template<typename Function>
+    bool for_each_object(const State& state, Function&& function) const {
         const auto& instance_info = *state.get_instance_info();
         const auto& atoms = instance_info.get_atoms();
-        for (int atom_idx : state.get_atom_indices()) {
+        for (int atom_idx : state.get_atom_indices(m_predicate.get_index())) {
             const auto& atom = atoms[atom_idx];
-            if (atom.get_predicate_index() == m_predicate.get_index()) {
-                assert(dlplan::utils::in_bounds(m_pos, atom.get_object_indices()));
-                result.insert(atom.get_object_indices()[m_pos]);
-            }
+            assert(dlplan::utils::in_bounds(m_pos, atom.get_object_indices()));
+            if (!function(atom.get_object_indices()[m_pos])) return false;
         }
-        for (const auto &atom : state.get_instance_info()->get_static_atoms()) {
-            if (atom.get_predicate_index() == m_predicate.get_index()) {
-                assert(dlplan::utils::in_bounds(m_pos, atom.get_object_indices()));
-                result.insert(atom.get_object_indices()[m_pos]);
-            }
+        const auto& static_atoms = instance_info.get_static_atoms();
+        for (int atom_idx : instance_info.get_static_atom_indices(m_predicate.get_index())) {
+            const auto& atom = static_atoms[atom_idx];
+            assert(dlplan::utils::in_bounds(m_pos, atom.get_object_indices()));
+            if (!function(atom.get_object_indices()[m_pos])) return false;
         }
+        return true;
+    }
+
+    void compute_result(const State& state, ConceptDenotation& result) const {
+        for_each_object(state, [&](ObjectIndex object) {
+            result.insert(object);
+            return true;
+        });
     }
 
     ConceptDenotation evaluate_impl(const State& state, DenotationsCaches&) const override {
@@ -55,6 +62,10 @@ private:
         return denotations;
     }
 
+    void evaluate_impl(const State& state, const EvaluationOperands&, ConceptDenotation& denotation) const override {
+        compute_result(state, denotation);
+    }
+
 protected:
     const Predicate m_predicate;
     const int m_pos;
@@ -73,6 +84,14 @@ public:
         return denotation;
     }
 
+    std::vector<const BaseElement*> get_children() const override {
+        return {};
+    }
+
+    bool for_each(const State& state, const std::function<bool(ObjectIndex)>& function) const override {
+        return for_each_object(state, function);
+    }
+
     int compute_complexity() const override {
         return 1;
     }
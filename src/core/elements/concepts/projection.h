@@ -15,7 +15,7 @@ namespace dlplan::core {
 class ProjectionConcept : public Concept {
 private:
     void compute_result(const RoleDenotation& denot, ConceptDenotation& result) const {
-        for (const auto& pair : denot.to_vector()) {
+        for (const auto pair : denot) {
             if (m_pos == 0) result.insert(pair.first);
             else if (m_pos == 1) result.insert(pair.second);
         }
@@ -43,6 +43,12 @@ private:
        return denotations;
     }
 
+    void evaluate_impl(const State&, const EvaluationOperands& operands, ConceptDenotation& denotation) const override {
+        compute_result(
+            operands.get_denotation(*m_role),
+            denotation);
+    }
+
 protected:
     const std::shared_ptr<const Role> m_role;
     const int m_pos;
@@ -66,6 +72,10 @@ public:
         return denotation;
     }
 
+    std::vector<const BaseElement*> get_children() const override {
+        return {m_role.get()};
+    }
+
     int compute_complexity() const override {
         return m_role->compute_complexity() + 1;
     }
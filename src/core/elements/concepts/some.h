@@ -16,9 +16,9 @@ class SomeConcept : public Concept {
 private:
     void compute_result(const RoleDenotation& role_denot, const ConceptDenotation& concept_denot, ConceptDenotation& result) const {
         // find examples a : exists b . (a,b) in R and b in C
-        for (const auto& pair : role_denot.to_vector()) {
-            if (concept_denot.contains(pair.second)) {
-                result.insert(pair.first);
+        for (int i = 0; i < role_denot.get_num_objects(); ++i) {
+            if (role_denot.successors_intersect(i, concept_denot)) {
+                result.insert(i);
             }
         }
     }
@@ -48,6 +48,13 @@ private:
         return denotations;
     }
 
+    void evaluate_impl(const State&, const EvaluationOperands& operands, ConceptDenotation& denotation) const override {
+        compute_result(
+            operands.get_denotation(*m_role),
+            operands.get_denotation(*m_concept),
+            denotation);
+    }
+
 protected:
     const std::shared_ptr<const Role> m_role;
     const std::shared_ptr<const Concept> m_concept;
@@ -70,6 +77,17 @@ public:
         return denotation;
     }
 
+    std::vector<const BaseElement*> get_children() const override {
+        return {m_role.get(), m_concept.get()};
+    }
+
+    bool for_each(const State& state, const std::function<bool(ObjectIndex)>& function) const override {
+        const auto concept_denot = m_concept->evaluate(state);
+        return m_role->for_each(state, [&](const PairOfObjectIndices& pair) {
+            return !concept_denot.contains(pair.second) || function(pair.first);
+        });
+    }
+
     int compute_complexity() const override {
         return m_role->compute_complexity() + m_concept->compute_complexity() + 1;
     }
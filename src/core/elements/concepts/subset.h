@@ -17,7 +17,7 @@ private:
     void compute_result(const RoleDenotation& left_denot, const RoleDenotation& right_denot, ConceptDenotation& result) const {
         // find counterexamples a : exists b . (a,b) in R and (a,b) notin S
         result.set();
-        for (const auto& pair : left_denot.to_vector()) {
+        for (const auto pair : left_denot) {
             if (!right_denot.contains(pair)) result.erase(pair.first);
         }
     }
@@ -48,6 +48,13 @@ private:
         return denotations;
     }
 
+    void evaluate_impl(const State&, const EvaluationOperands& operands, ConceptDenotation& denotation) const override {
+        compute_result(
+            operands.get_denotation(*m_role_left),
+            operands.get_denotation(*m_role_right),
+            denotation);
+    }
+
 protected:
     const std::shared_ptr<const Role> m_role_left;
     const std::shared_ptr<const Role> m_role_right;
@@ -70,6 +77,10 @@ public:
         return denotation;
     }
 
+    std::vector<const BaseElement*> get_children() const override {
+        return {m_role_left.get(), m_role_right.get()};
+    }
+
     int compute_complexity() const override {
         return m_role_left->compute_complexity() + m_role_right->compute_complexity() + 1;
     }
@@ -17,14 +17,14 @@ private:
         ConceptDenotation best_cell_denot(num_objects);
         int best_distance = -1;
 
-        for (auto potential_cell_id : concept_from_denot.to_vector()) {
+        for (auto potential_cell_id : concept_from_denot) {
             ConceptDenotation potential_cell(num_objects);
             potential_cell.insert(potential_cell_id);
             utils::Distances source_distances = utils::compute_multi_source_multi_target_shortest_distances(potential_cell, connection_denot, concept_to_denot);
 
             int result = 0;
 
-            for (const auto target : concept_to_denot.to_vector()) {
+            for (const auto target : concept_to_denot) {
                 result = utils::path_addition(result, source_distances[target]);
             }
 
@@ -45,7 +45,7 @@ private:
             ConceptDenotation potential_cell_denot(num_objects);
             utils::Distances source_distances = utils::compute_multi_source_multi_target_shortest_distances(best_cell_denot, connection_denot, concept_painted_denot);
 
-            for (auto potential_cell_id : concept_painted_denot.to_vector()) {
+            for (auto potential_cell_id : concept_painted_denot) {
                 std::cout << "id: " << potential_cell_id << " source distance: " << source_distances[potential_cell_id] << std::endl;
                 if (source_distances[potential_cell_id] == 1){
                     potential_cell_denot.insert(potential_cell_id);
@@ -54,7 +54,7 @@ private:
             utils::Distances potential_distances = utils::compute_multi_source_multi_target_shortest_distances(concept_robot_denot, connection_denot, potential_cell_denot);
             int best_adjacent_cell = -1;
             best_distance = INF;
-            for (auto potential_cell_id : potential_cell_denot.to_vector()) {
+            for (auto potential_cell_id : potential_cell_denot) {
                 int result = potential_distances[potential_cell_id];
                 std::cout << "id: " << potential_cell_id << " result: " << result << std::endl;
                 if (result < best_distance) {
@@ -93,6 +93,16 @@ private:
         return denotations;
     }
 
+    void evaluate_impl(const State& state, const EvaluationOperands& operands, ConceptDenotation& denotation) const override {
+        int num_objects = state.get_instance_info()->get_objects().size();
+        const auto& concept_from_denot = operands.get_denotation(*m_from_concept);
+        const auto& concept_to_denot = operands.get_denotation(*m_to_concept);
+        const auto& connection_denot = operands.get_denotation(*m_connection);
+        const auto& concept_painted_denot = operands.get_denotation(*m_painted_concept);
+        const auto& concept_robot_denot = operands.get_denotation(*m_robot_concept);
+        compute_result(concept_from_denot, connection_denot, concept_to_denot, concept_painted_denot, concept_robot_denot, denotation, num_objects);
+    }
+
 protected:
     const std::shared_ptr<const Concept> m_from_concept;
     const std::shared_ptr<const Role> m_connection;
@@ -132,6 +142,10 @@ public:
         return denotation;
     }
 
+    std::vector<const BaseElement*> get_children() const override {
+        return {m_from_concept.get(), m_connection.get(), m_to_concept.get(), m_painted_concept.get(), m_robot_concept.get()};
+    }
+
     int compute_complexity() const override {
         return m_from_concept->compute_complexity() + m_connection->compute_complexity() + m_to_concept->compute_complexity() + m_painted_concept->compute_complexity() + m_robot_concept->compute_complexity() + 1;
     }
@@ -31,6 +31,10 @@ private:
         return denotations;
     }
 
+    void evaluate_impl(const State&, const EvaluationOperands&, ConceptDenotation& denotation) const override {
+        denotation.set();
+    }
+
 public:
     TopConcept(std::shared_ptr<const VocabularyInfo> vocabulary_info)
     : Concept(vocabulary_info, true) {
@@ -42,6 +46,10 @@ public:
         return denotation;
     }
 
+    std::vector<const BaseElement*> get_children() const override {
+        return {};
+    }
+
     int compute_complexity() const override {
         return 1;
     }
@@ -14,8 +14,12 @@ namespace dlplan::core {
 
 class ConceptDistanceNumerical : public Numerical {
 private:
-    void compute_result(const ConceptDenotation& concept_from_denot, const RoleDenotation& role_denot, const ConceptDenotation& concept_to_denot, int& result) const {
-        result = utils::compute_multi_source_multi_target_shortest_distance(concept_from_denot, role_denot, concept_to_denot);
+    void compute_result(const ConceptDenotation& concept_from_denot, const RoleDenotation& role_denot, const utils::DistanceMatrix* distances, const ConceptDenotation& concept_to_denot, int& result) const {
+        if (distances) {
+            result = utils::compute_multi_source_multi_target_shortest_distance(concept_from_denot, *distances, concept_to_denot);
+        } else {
+            result = utils::compute_multi_source_multi_target_shortest_distance(concept_from_denot, role_denot, concept_to_denot);
+        }
     }
 
     int evaluate_impl(const State& state, DenotationsCaches& caches) const override {
@@ -32,10 +36,7 @@ private:
         }
         auto role_denot = m_role->evaluate(state, caches);
         int denotation;
-        compute_result(
-            *concept_from_denot,
-            *role_denot,
-            *concept_to_denot, denotation);
+        compute_result(*concept_from_denot, *role_denot, utils::get_pairwise_distances(role_denot, caches), *concept_to_denot, denotation);
         return denotation;
     }
 
@@ -62,6 +63,7 @@ private:
             compute_result(
                 *(*concept_from_denots)[i],
                 *(*role_denots)[i],
+                utils::get_pairwise_distances((*role_denots)[i], caches),
                 *(*concept_to_denots)[i],
                 denotation);
             denotations.push_back(denotation);
@@ -69,6 +71,24 @@ private:
         return denotations;
     }
 
+    int evaluate_impl(const State&, const EvaluationOperands& operands) const override {
+        const auto& concept_from_denot = operands.get_denotation(*m_concept_from);
+        if (concept_from_denot.empty()) {
+            return INF;
+        }
+        const auto& concept_to_denot = operands.get_denotation(*m_concept_to);
+        if (concept_to_denot.empty()) {
+            return INF;
+        }
+        if (concept_from_denot.intersects(concept_to_denot)) {
+            return 0;
+        }
+        const auto& role_denot = operands.get_denotation(*m_role);
+        int denotation;
+        compute_result(concept_from_denot, role_denot, nullptr, concept_to_denot, denotation);
+        return denotation;
+    }
+
 protected:
     const std::shared_ptr<const Concept> m_concept_from;
     const std::shared_ptr<const Role> m_role;
@@ -97,10 +117,14 @@ public:
         }
         auto role_denot = m_role->evaluate(state);
         int denotation;
-        compute_result(concept_from_denot, role_denot, concept_to_denot, denotation);
+        compute_result(concept_from_denot, role_denot, nullptr, concept_to_denot, denotation);
         return denotation;
     }
 
+    std::vector<const BaseElement*> get_children() const override {
+        return {m_concept_from.get(), m_role.get(), m_concept_to.get()};
+    }
+
     int compute_complexity() const override {
         return m_concept_from->compute_complexity() + m_role->compute_complexity() + m_concept_to->compute_complexity() + 1;
     }
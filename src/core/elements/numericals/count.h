@@ -42,6 +42,14 @@ private:
         return denotations;
     }
 
+    int evaluate_impl(const State&, const EvaluationOperands& operands) const override {
+        int result;
+        compute_result(
+            operands.get_denotation(*m_element),
+            result);
+        return result;
+    }
+
 protected:
     const std::shared_ptr<const T> m_element;
 
@@ -57,6 +65,10 @@ public:
         return result;
     }
 
+    std::vector<const BaseElement*> get_children() const override {
+        return {m_element.get()};
+    }
+
     int compute_complexity() const override {
         return m_element->compute_complexity() + 1;
     }
@@ -14,19 +14,19 @@ namespace dlplan::core {
 
 class RoleDistanceNumerical : public Numerical {
 private:
-    void compute_result(const RoleDenotation& role_from_denot, const RoleDenotation& role_denot, const RoleDenotation& role_to_denot, int& result) const {
-        utils::PairwiseDistances pairwise_distances = utils::compute_floyd_warshall(role_denot);
+    void compute_result(const RoleDenotation& role_from_denot, const RoleDenotation& role_denot, const utils::DistanceMatrix* distances, const RoleDenotation& role_to_denot, int& result) const {
         result = INF;
         int num_objects = role_denot.get_num_objects();
         for (int k = 0; k < num_objects; ++k) {  // property
-            for (int i = 0; i < num_objects; ++i) {  // source
-                if (role_from_denot.contains(std::make_pair(k, i))) {
-                    for (int j = 0; j < num_objects; ++j) {  // target
-                        if (role_to_denot.contains(std::make_pair(k, j))) {
-                            result = std::min<int>(result, pairwise_distances[i][j]);
-                        }
-                    }
-                }
+            if (!role_from_denot.has_successors(k) || !role_to_denot.has_successors(k)) {
+                continue;
+            }
+            if (distances) {
+                result = std::min<int>(result, utils::compute_multi_source_multi_target_shortest_distance(
+                    role_from_denot.get_successors(k), *distances, role_to_denot.get_successors(k)));
+            } else {
+                result = std::min<int>(result, utils::compute_multi_source_multi_target_shortest_distance(
+                    role_from_denot.get_successors(k), role_denot, role_to_denot.get_successors(k)));
             }
         }
     }
@@ -42,7 +42,7 @@ private:
         }
         auto role_denot = m_role->evaluate(state, caches);
         int denotation;
-        compute_result(*role_from_denot, *role_denot, *role_to_denot, denotation);
+        compute_result(*role_from_denot, *role_denot, utils::get_pairwise_distances(role_denot, caches), *role_to_denot, denotation);
         return denotation;
     }
 
@@ -65,6 +65,7 @@ private:
             compute_result(
                 *(*role_from_denots)[i],
                 *(*role_denots)[i],
+                utils::get_pairwise_distances((*role_denots)[i], caches),
                 *(*role_to_denots)[i],
                 denotation);
             denotations.push_back(denotation);
@@ -72,6 +73,21 @@ private:
         return denotations;
     }
 
+    int evaluate_impl(const State&, const EvaluationOperands& operands) const override {
+        const auto& role_from_denot = operands.get_denotation(*m_role_from);
+        if (role_from_denot.empty()) {
+            return INF;
+        }
+        const auto& role_to_denot = operands.get_denotation(*m_role_to);
+        if (role_to_denot.empty()) {
+            return INF;
+        }
+        const auto& role_denot = operands.get_denotation(*m_role);
+        int denotation;
+        compute_result(role_from_denot, role_denot, nullptr, role_to_denot, denotation);
+        return denotation;
+    }
+
 protected:
     const std::shared_ptr<const Role> m_role_from;
     const std::shared_ptr<const Role> m_role;
@@ -97,10 +113,14 @@ public:
         }
         auto role_denot = m_role->evaluate(state);
         int denotation;
-        compute_result(role_from_denot, role_denot, role_to_denot, denotation);
+        compute_result(role_from_denot, role_denot, nullptr, role_to_denot, denotation);
         return denotation;
     }
 
+    std::vector<const BaseElement*> get_children() const override {
+        return {m_role_from.get(), m_role.get(), m_role_to.get()};
+    }
+
     int compute_complexity() const override {
         return m_role_from->compute_complexity() + m_role->compute_complexity() + m_role_to->compute_complexity() + 1;
     }
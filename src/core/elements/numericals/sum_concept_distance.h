@@ -14,10 +14,21 @@ namespace dlplan::core {
 
 class SumConceptDistanceNumerical : public Numerical {
 private:
-    void compute_result(const ConceptDenotation& concept_from_denot, const RoleDenotation& role_denot, const ConceptDenotation& concept_to_denot, int& result) const {
+    void compute_result(const ConceptDenotation& concept_from_denot, const RoleDenotation& role_denot, const utils::DistanceMatrix* distances, const ConceptDenotation& concept_to_denot, int& result) const {
         result = 0;
+        if (distances) {
+            std::size_t num_objects = role_denot.get_num_objects();
+            concept_to_denot.for_each([&](ObjectIndex target) {
+                std::int16_t distance = utils::DISTANCE_MATRIX_INF;
+                concept_from_denot.for_each([&](ObjectIndex source) {
+                    distance = std::min(distance, (*distances)[source * num_objects + target]);
+                });
+                result = utils::path_addition(result, (distance == utils::DISTANCE_MATRIX_INF) ? INF : distance);
+            });
+            return;
+        }
         utils::Distances source_distances = utils::compute_multi_source_multi_target_shortest_distances(concept_from_denot, role_denot, concept_to_denot);
-        for (const auto target : concept_to_denot.to_vector()) {
+        for (const auto target : concept_to_denot) {
             result = utils::path_addition(result, source_distances[target]);
         }
     }
@@ -36,10 +47,7 @@ private:
         }
         auto role_denot = m_role->evaluate(state, caches);
         int denotation;
-        compute_result(
-            *concept_from_denot,
-            *role_denot,
-            *concept_to_denot, denotation);
+        compute_result(*concept_from_denot, *role_denot, utils::get_pairwise_distances(role_denot, caches), *concept_to_denot, denotation);
         return denotation;
     }
 
@@ -62,6 +70,7 @@ private:
             compute_result(
                 *(*concept_from_denots)[i],
                 *(*role_denots)[i],
+                utils::get_pairwise_distances((*role_denots)[i], caches),
                 *(*concept_to_denots)[i],
                 denotation);
             denotations.push_back(denotation);
@@ -69,6 +78,21 @@ private:
         return denotations;
     }
 
+    int evaluate_impl(const State&, const EvaluationOperands& operands) const override {
+        const auto& concept_from_denot = operands.get_denotation(*m_concept_from);
+        if (concept_from_denot.empty()) {
+            return INF;
+        }
+        const auto& concept_to_denot = operands.get_denotation(*m_concept_to);
+        if (concept_to_denot.empty()) {
+            return INF;
+        }
+        const auto& role_denot = operands.get_denotation(*m_role);
+        int denotation;
+        compute_result(concept_from_denot, role_denot, nullptr, concept_to_denot, denotation);
+        return denotation;
+    }
+
 protected:
     const std::shared_ptr<const Concept> m_concept_from;
     const std::shared_ptr<const Role> m_role;
@@ -94,10 +118,14 @@ public:
         }
         auto role_denot = m_role->evaluate(state);
         int denotation;
-        compute_result(concept_from_denot, role_denot, concept_to_denot, denotation);
+        compute_result(concept_from_denot, role_denot, nullptr, concept_to_denot, denotation);
         return denotation;
     }
 
+    std::vector<const BaseElement*> get_children() const override {
+        return {m_concept_from.get(), m_role.get(), m_concept_to.get()};
+    }
+
     int compute_complexity() const override {
         return m_concept_from->compute_complexity() + m_role->compute_complexity() + m_concept_to->compute_complexity() + 1;
     }
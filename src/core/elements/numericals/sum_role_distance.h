@@ -14,23 +14,40 @@ namespace dlplan::core {
 
 class SumRoleDistanceNumerical : public Numerical {
 private:
-    void compute_result(const RoleDenotation& role_from_denot, const RoleDenotation& role_denot, const RoleDenotation& role_to_denot, int& result) const {
-        utils::PairwiseDistances pairwise_distances = utils::compute_floyd_warshall(role_denot);
-        result = 0;
+    void compute_result(const RoleDenotation& role_from_denot, const RoleDenotation& role_denot, const utils::DistanceMatrix* distances, const RoleDenotation& role_to_denot, int& result) const {
         int num_objects = role_denot.get_num_objects();
-        for (int k = 0; k < num_objects; ++k) {  // property
-            for (int i = 0; i < num_objects; ++i) {  // source
-                if (role_from_denot.contains(std::make_pair(k, i))) {
-                    int min_distance = INF;
-                    for (int j = 0; j < num_objects; ++j) {  // target
-                        if (role_to_denot.contains(std::make_pair(k, j))) {
-                            min_distance = std::min<int>(min_distance, pairwise_distances[i][j]);
-                        }
-                    }
-                    result = utils::path_addition(result, min_distance);
+        if (distances) {
+            result = 0;
+            for (int k = 0; k < num_objects; ++k) {  // property
+                if (!role_from_denot.has_successors(k)) {
+                    continue;
                 }
+                ConceptDenotation targets = role_to_denot.get_successors(k);
+                role_from_denot.get_successors(k).for_each([&](ObjectIndex source) {
+                    const std::int16_t* row = distances->data() + static_cast<std::size_t>(source) * num_objects;
+                    std::int16_t distance = utils::DISTANCE_MATRIX_INF;
+                    targets.for_each([&](ObjectIndex target) { distance = std::min(distance, row[target]); });
+                    result = utils::path_addition(result, (distance == utils::DISTANCE_MATRIX_INF) ? INF : distance);
+                });
+            }
+            return;
+        }
+        // One backward search from the targets of every property that has sources.
+        std::vector<ObjectIndex> properties;
+        std::vector<ConceptDenotation> targets;
+        for (int k = 0; k < num_objects; ++k) {  // property
+            if (role_from_denot.has_successors(k)) {
+                properties.push_back(k);
+                targets.push_back(role_to_denot.get_successors(k));
             }
         }
+        utils::PairwiseDistances target_distances = utils::compute_multi_target_shortest_distances(role_denot, targets);
+        result = 0;
+        for (std::size_t i = 0; i < properties.size(); ++i) {
+            role_from_denot.get_successors(properties[i]).for_each([&](ObjectIndex source) {
+                result = utils::path_addition(result, target_distances[i][source]);
+            });
+        }
     }
 
     int evaluate_impl(const State& state, DenotationsCaches& caches) const override {
@@ -44,7 +61,7 @@ private:
         }
         auto role_denot = m_role->evaluate(state, caches);
         int denotation;
-        compute_result(*role_from_denot, *role_denot, *role_to_denot, denotation);
+        compute_result(*role_from_denot, *role_denot, utils::get_pairwise_distances(role_denot, caches), *role_to_denot, denotation);
         return denotation;
     }
 
@@ -67,6 +84,7 @@ private:
             compute_result(
                 *(*role_from_denots)[i],
                 *(*role_denots)[i],
+                utils::get_pairwise_distances((*role_denots)[i], caches),
                 *(*role_to_denots)[i],
                 denotation);
             denotations.push_back(denotation);
@@ -74,6 +92,21 @@ private:
         return denotations;
     }
 
+    int evaluate_impl(const State&, const EvaluationOperands& operands) const override {
+        const auto& role_from_denot = operands.get_denotation(*m_role_from);
+        if (role_from_denot.empty()) {
+            return INF;
+        }
+        const auto& role_to_denot = operands.get_denotation(*m_role_to);
+        if (role_to_denot.empty()) {
+            return INF;
+        }
+        const auto& role_denot = operands.get_denotation(*m_role);
+        int denotation;
+        compute_result(role_from_denot, role_denot, nullptr, role_to_denot, denotation);
+        return denotation;
+    }
+
 protected:
     const std::shared_ptr<const Role> m_role_from;
     const std::shared_ptr<const Role> m_role;
@@ -99,10 +132,14 @@ public:
         }
         auto role_denot = m_role->evaluate(state);
         int denotation;
-        compute_result(role_from_denot, role_denot, role_to_denot, denotation);
+        compute_result(role_from_denot, role_denot, nullptr, role_to_denot, denotation);
         return denotation;
     }
 
+    std::vector<const BaseElement*> get_children() const override {
+        return {m_role_from.get(), m_role.get(), m_role_to.get()};
+    }
+
     int compute_complexity() const override {
         return m_role_from->compute_complexity() + m_role->compute_complexity() + m_role_to->compute_complexity() + 1;
     }
@@ -15,16 +15,8 @@ namespace dlplan::core {
 class ComposeRole : public Role {
 private:
     void compute_result(const RoleDenotation& left_denot, const RoleDenotation& right_denot, RoleDenotation& result) const {
-        // Compute sparse representation.
-        PairsOfObjectIndices left_pairs = left_denot.to_vector();
-        PairsOfObjectIndices right_pairs = right_denot.to_vector();
-        for (const auto& left_pair : left_pairs) {  // source
-            for (const auto& right_pair : right_pairs) {  // target
-                if (left_pair.second == right_pair.first) {
-                    result.insert(std::make_pair(left_pair.first, right_pair.second));
-                }
-            }
-        }
+        // (a,c) in result iff exists b . (a,b) in left and (b,c) in right
+        result.insert_composition(left_denot, right_denot);
     }
 
     RoleDenotation evaluate_impl(const State& state, DenotationsCaches& caches) const override {
@@ -52,6 +44,13 @@ private:
         return denotations;
     }
 
+    void evaluate_impl(const State&, const EvaluationOperands& operands, RoleDenotation& denotation) const override {
+        compute_result(
+            operands.get_denotation(*m_role_left),
+            operands.get_denotation(*m_role_right),
+            denotation);
+    }
+
 protected:
     const std::shared_ptr<const Role> m_role_left;
     const std::shared_ptr<const Role> m_role_right;
@@ -73,6 +72,10 @@ public:
         return denotation;
     }
 
+    std::vector<const BaseElement*> get_children() const override {
+        return {m_role_left.get(), m_role_right.get()};
+    }
+
     int compute_complexity() const override {
         return m_role_left->compute_complexity() + m_role_right->compute_complexity() + 1;
     }
@@ -15,7 +15,7 @@ namespace dlplan::core {
 class IdentityRole : public Role {
 private:
     void compute_result(const ConceptDenotation& denot, RoleDenotation& result) const {
-        for (const auto& single : denot.to_vector()) {
+        for (const auto single : denot) {
             result.insert(std::make_pair(single, single));
         }
     }
@@ -42,6 +42,12 @@ private:
        return denotations;
     }
 
+    void evaluate_impl(const State&, const EvaluationOperands& operands, RoleDenotation& denotation) const override {
+        compute_result(
+            operands.get_denotation(*m_concept),
+            denotation);
+    }
+
 protected:
     const std::shared_ptr<const Concept> m_concept;
 
@@ -61,6 +67,16 @@ public:
         return denotation;
     }
 
+    std::vector<const BaseElement*> get_children() const override {
+        return {m_concept.get()};
+    }
+
+    bool for_each(const State& state, const std::function<bool(const PairOfObjectIndices&)>& function) const override {
+        return m_concept->for_each(state, [&](ObjectIndex object) {
+            return function(std::make_pair(object, object));
+        });
+    }
+
     int compute_complexity() const override {
         return m_concept->compute_complexity() + 1;
     }
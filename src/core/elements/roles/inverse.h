@@ -15,7 +15,7 @@ namespace dlplan::core {
 class InverseRole : public Role {
 private:
     void compute_result(const RoleDenotation& denot, RoleDenotation& result) const {
-        for (const auto& pair : denot.to_vector()) {
+        for (const auto pair : denot) {
             result.insert(std::make_pair(pair.second, pair.first));
         }
     }
@@ -42,6 +42,12 @@ private:
        return denotations;
     }
 
+    void evaluate_impl(const State&, const EvaluationOperands& operands, RoleDenotation& denotation) const override {
+        compute_result(
+            operands.get_denotation(*m_role),
+            denotation);
+    }
+
 protected:
     const std::shared_ptr<const Role> m_role;
 
@@ -61,6 +67,16 @@ public:
         return denotation;
     }
 
+    std::vector<const BaseElement*> get_children() const override {
+        return {m_role.get()};
+    }
+
+    bool for_each(const State& state, const std::function<bool(const PairOfObjectIndices&)>& function) const override {
+        return m_role->for_each(state, [&](const PairOfObjectIndices& pair) {
+            return function(std::make_pair(pair.second, pair.first));
+        });
+    }
+
     int compute_complexity() const override {
         return m_role->compute_complexity() + 1;
     }
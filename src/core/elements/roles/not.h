@@ -41,6 +41,12 @@ private:
        return denotations;
     }
 
+    void evaluate_impl(const State&, const EvaluationOperands& operands, RoleDenotation& denotation) const override {
+        compute_result(
+            operands.get_denotation(*m_role),
+            denotation);
+    }
+
 protected:
     const std::shared_ptr<const Role> m_role;
 
@@ -60,6 +66,10 @@ public:
         return denotation;
     }
 
+    std::vector<const BaseElement*> get_children() const override {
+        return {m_role.get()};
+    }
+
     int compute_complexity() const override {
         return m_role->compute_complexity() + 1;
     }
@@ -44,6 +44,13 @@ private:
         return denotations;
     }
 
+    void evaluate_impl(const State&, const EvaluationOperands& operands, RoleDenotation& denotation) const override {
+        compute_result(
+            operands.get_denotation(*m_role_left),
+            operands.get_denotation(*m_role_right),
+            denotation);
+    }
+
 protected:
     std::shared_ptr<const Role> m_role_left;
     std::shared_ptr<const Role> m_role_right;
@@ -72,6 +79,14 @@ public:
         return denotation;
     }
 
+    std::vector<const BaseElement*> get_children() const override {
+        return {m_role_left.get(), m_role_right.get()};
+    }
+
+    bool for_each(const State& state, const std::function<bool(const PairOfObjectIndices&)>& function) const override {
+        return m_role_left->for_each(state, function) && m_role_right->for_each(state, function);
+    }
+
     int compute_complexity() const override {
         return m_role_left->compute_complexity() + m_role_right->compute_complexity() + 1;
     }
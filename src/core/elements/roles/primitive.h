@@ -17,23 +17,10 @@ namespace dlplan::core {
 class PrimitiveRole : public Role {
 private:
     void compute_result(const State& state, RoleDenotation& result) const {
-        const auto& instance_info = *state.get_instance_info();
-        const auto& atoms = instance_info.get_atoms();
-        for (int atom_idx : state.get_atom_indices()) {
-            const auto& atom = atoms[atom_idx];
-            if (atom.get_predicate_index() == m_predicate.get_index()) {
-                assert(dlplan::utils::in_bounds(m_pos_1, atom.get_object_indices()));
-                assert(dlplan::utils::in_bounds(m_pos_2, atom.get_object_indices()));
-                result.insert(std::make_pair(atom.get_object_indices()[m_pos_1], atom.get_object_indices()[m_pos_2]));
-            }
-        }
-        for (const auto& atom : state.get_instance_info()->get_static_atoms()) {
-            if (atom.get_predicate_index() == m_predicate.get_index()) {
-                assert(dlplan::utils::in_bounds(m_pos_1, atom.get_object_indices()));
-                assert(dlplan::utils::in_bounds(m_pos_2, atom.get_object_indices()));
-                result.insert(std::make_pair(atom.get_object_indices()[m_pos_1], atom.get_object_indices()[m_pos_2]));
-            }
-        }
+        for_each_pair(state, [&](const PairOfObjectIndices& pair) {
+            result.insert(pair);
+            return true;
+        });
     }
 
     RoleDenotation evaluate_impl(const State& state, DenotationsCaches&) const override {
@@ -57,6 +44,10 @@ private:
         return denotations;
     }
 
+    void evaluate_impl(const State& state, const EvaluationOperands&, RoleDenotation& denotation) const override {
+        compute_result(state, denotation);
+    }
+
 protected:
     const Predicate m_predicate;
     const int m_pos_1;
@@ -76,6 +67,14 @@ public:
         return denotation;
     }
 
+    std::vector<const BaseElement*> get_children() const override {
+        return {};
+    }
+
+    bool for_each(const State& state, const std::function<bool(const PairOfObjectIndices&)>& function) const override {
+        return for_each_pair(state, function);
+    }
+
     int compute_complexity() const override {
         return 1;
     }
@@ -95,6 +94,29 @@ public:
     const Predicate& get_predicate() const {
         return m_predicate;
     }
+
+    /// @brief Calls function on each pair of the denotation in the state,
+    ///        directly from the atoms, until function returns false.
+    /// @return false iff function returned false.
+    template<typename Function>
+    bool for_each_pair(const State& state, Function&& function) const {
+        const auto& instance_info = *state.get_instance_info();
+        const auto& atoms = instance_info.get_atoms();
+        for (int atom_idx : state.get_atom_indices(m_predicate.get_index())) {
+            const auto& atom = atoms[atom_idx];
+            assert(dlplan::utils::in_bounds(m_pos_1, atom.get_object_indices()));
+            assert(dlplan::utils::in_bounds(m_pos_2, atom.get_object_indices()));
+            if (!function(std::make_pair(atom.get_object_indices()[m_pos_1], atom.get_object_indices()[m_pos_2]))) return false;
+        }
+        const auto& static_atoms = instance_info.get_static_atoms();
+        for (int atom_idx : instance_info.get_static_atom_indices(m_predicate.get_index())) {
+            const auto& atom = static_atoms[atom_idx];
+            assert(dlplan::utils::in_bounds(m_pos_1, atom.get_object_indices()));
+            assert(dlplan::utils::in_bounds(m_pos_2, atom.get_object_indices()));
+            if (!function(std::make_pair(atom.get_object_indices()[m_pos_1], atom.get_object_indices()[m_pos_2]))) return false;
+        }
+        return true;
+    }
 };
 
 }
@@ -16,10 +16,8 @@ class RestrictRole : public Role {
 private:
     void compute_result(const RoleDenotation& role_denot, const ConceptDenotation& concept_denot, RoleDenotation& result) const {
         result = role_denot;
-        for (const auto& pair : role_denot.to_vector()) {
-            if (!concept_denot.contains(pair.second)) {
-                result.erase(pair);
-            }
+        for (int i = 0; i < result.get_num_objects(); ++i) {
+            result.restrict_successors(i, concept_denot);
         }
     }
 
@@ -48,6 +46,13 @@ private:
         return denotations;
     }
 
+    void evaluate_impl(const State&, const EvaluationOperands& operands, RoleDenotation& denotation) const override {
+        compute_result(
+            operands.get_denotation(*m_role),
+            operands.get_denotation(*m_concept),
+            denotation);
+    }
+
 protected:
     const std::shared_ptr<const Role> m_role;
     const std::shared_ptr<const Concept> m_concept;
@@ -71,6 +76,17 @@ public:
         return denotation;
     }
 
+    std::vector<const BaseElement*> get_children() const override {
+        return {m_role.get(), m_concept.get()};
+    }
+
+    bool for_each(const State& state, const std::function<bool(const PairOfObjectIndices&)>& function) const override {
+        const auto concept_denot = m_concept->evaluate(state);
+        return m_role->for_each(state, [&](const PairOfObjectIndices& pair) {
+            return !concept_denot.contains(pair.second) || function(pair);
+        });
+    }
+
     int compute_complexity() const override {
         return m_role->compute_complexity() + m_concept->compute_complexity() + 1;
     }
@@ -31,6 +31,10 @@ private:
         return denotations;
     }
 
+    void evaluate_impl(const State&, const EvaluationOperands&, RoleDenotation& denotation) const override {
+        denotation.set();
+    }
+
 public:
     TopRole(std::shared_ptr<const VocabularyInfo> vocabulary_info)
     : Role(vocabulary_info, true) {
@@ -43,6 +47,10 @@ public:
 
     }
 
+    std::vector<const BaseElement*> get_children() const override {
+        return {};
+    }
+
     int compute_complexity() const override {
         return 1;
     }
@@ -12,24 +12,11 @@ using namespace std::string_literals;
 
 namespace dlplan::core {
 
-// https://stackoverflow.com/questions/3517524/what-is-the-best-known-transitive-closure-algorithm-for-a-directed-graph
 class TransitiveClosureRole : public Role {
 private:
     void compute_result(const RoleDenotation& denot, RoleDenotation& result) const {
         result = denot;
-        bool changed = false;
-        do {
-            RoleDenotation tmp_result = result;
-            PairsOfObjectIndices pairs = tmp_result.to_vector();
-            for (const auto& pair_1 : pairs) {
-                for (const auto& pair_2 : pairs) {
-                    if (pair_1.second == pair_2.first) {
-                        result.insert(std::make_pair(pair_1.first, pair_2.second));
-                    }
-                }
-            }
-            changed = (result.size() != tmp_result.size());
-        } while (changed);
+        result.transitive_closure();
     }
 
     RoleDenotation evaluate_impl(const State& state, DenotationsCaches& caches) const override {
@@ -54,6 +41,12 @@ private:
        return denotations;
     }
 
+    void evaluate_impl(const State&, const EvaluationOperands& operands, RoleDenotation& result) const override {
+        compute_result(
+            operands.get_denotation(*m_role),
+            result);
+    }
+
 protected:
     const std::shared_ptr<const Role> m_role;
 
@@ -73,6 +66,10 @@ public:
         return result;
     }
 
+    std::vector<const BaseElement*> get_children() const override {
+        return {m_role.get()};
+    }
+
     int compute_complexity() const override {
         return m_role->compute_complexity() + 1;
     }
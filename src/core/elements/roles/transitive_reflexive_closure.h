@@ -16,19 +16,7 @@ class TransitiveReflexiveClosureRole : public Role {
 private:
     void compute_result(const RoleDenotation& denot, int num_objects, RoleDenotation& result) const {
         result = denot;
-        bool changed = false;
-        do {
-            RoleDenotation tmp_result = result;
-            PairsOfObjectIndices pairs = tmp_result.to_vector();
-            for (const auto& pair_1 : pairs) {
-                for (const auto& pair_2 : pairs) {
-                    if (pair_1.second == pair_2.first) {
-                        result.insert(std::make_pair(pair_1.first, pair_2.second));
-                    }
-                }
-            }
-            changed = (result.size() != tmp_result.size());
-        } while (changed);
+        result.transitive_closure();
         // add reflexive part
         for (int i = 0; i < num_objects; ++i) {
             result.insert(std::make_pair(i, i));
@@ -59,6 +47,14 @@ private:
        return denotations;
     }
 
+    void evaluate_impl(const State& state, const EvaluationOperands& operands, RoleDenotation& denotation) const override {
+        int num_objects = state.get_instance_info()->get_objects().size();
+        compute_result(
+            operands.get_denotation(*m_role),
+            num_objects,
+            denotation);
+    }
+
 protected:
     const std::shared_ptr<const Role> m_role;
 
@@ -80,6 +76,10 @@ public:
         return denotation;
     }
 
+    std::vector<const BaseElement*> get_children() const override {
+        return {m_role.get()};
+    }
+
     int compute_complexity() const override {
         return m_role->compute_complexity() + 1;
     }
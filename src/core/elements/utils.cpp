@@ -1,5 +1,6 @@
 #include "utils.h"
 
+#include <algorithm>
 #include <deque>
 #include <iostream>
 
@@ -26,7 +27,7 @@ int path_addition(int a, int b) {
 AdjList compute_adjacency_list(const RoleDenotation& role_denot, bool forward=true) {
     int num_objects = role_denot.get_num_objects();
     AdjList adjacency_list(num_objects);
-    for (const auto& pair : role_denot.to_vector()) {
+    for (const auto pair : role_denot) {
         if (forward) adjacency_list[pair.first].push_back(pair.second);
         else adjacency_list[pair.second].push_back(pair.first);
     }
@@ -54,32 +55,24 @@ Distances compute_distances_from_state(const AdjList& adj_list, int source) {
 }
 
 
+/*
+  Breadth-first search with one layer per iteration. The next layer is the
+  union of the successors of the current layer, which are whole rows of
+  dense role denotations, minus the objects that were already visited.
+*/
 int compute_multi_source_multi_target_shortest_distance(const ConceptDenotation& sources, const RoleDenotation& edges, const ConceptDenotation& targets) {
-    int num_objects = targets.get_num_objects();
-    Distances distances(num_objects, INF);
-    std::deque<int> queue;
-    for (int source : sources.to_vector()) {
-        distances[source] = 0;
-        queue.push_back(source);
-        if (targets.contains(source)) {
-            return 0;
-        }
+    if (sources.intersects(targets)) {
+        return 0;
     }
-    while (!queue.empty()) {
-        int source = queue.front();
-        queue.pop_front();
-        for (int target = 0; target < num_objects; ++target) {
-            if (edges.contains(std::make_pair(source,target))) {
-                int alt = distances[source] + 1;
-                if (distances[target] > alt) {
-                    if (targets.contains(target)) {
-                        return alt;
-                    }
-                    queue.push_back(target);
-                    distances[target] = alt;
-                }
-            }
+    ConceptDenotation visited = sources;
+    ConceptDenotation layer = sources;
+    for (int distance = 1; !layer.empty(); ++distance) {
+        layer = edges.get_successors(layer);
+        layer -= visited;
+        if (layer.intersects(targets)) {
+            return distance;
         }
+        visited |= layer;
     }
     return INF;
 }
@@ -88,28 +81,151 @@ int compute_multi_source_multi_target_shortest_distance(const ConceptDenotation&
 Distances compute_multi_source_multi_target_shortest_distances(const ConceptDenotation& sources, const RoleDenotation& edges, const ConceptDenotation& targets) {
     int num_objects = targets.get_num_objects();
     Distances distances(num_objects, INF);
-    std::deque<int> queue;
-    for (int source : sources.to_vector()) {
-        distances[source] = 0;
-        queue.push_back(source);
+    sources.for_each([&](ObjectIndex source) { distances[source] = 0; });
+    ConceptDenotation visited = sources;
+    ConceptDenotation layer = sources;
+    for (int distance = 1; !layer.empty(); ++distance) {
+        layer = edges.get_successors(layer);
+        layer -= visited;
+        layer.for_each([&](ObjectIndex target) { distances[target] = distance; });
+        visited |= layer;
     }
-    while (!queue.empty()) {
-        int source = queue.front();
-        queue.pop_front();
-        for (int target = 0; target < num_objects; ++target) {
-            if (edges.contains(std::make_pair(source, target))) {
-                int alt = distances[source] + 1;
-                if (distances[target] > alt) {
-                    queue.push_back(target);
-                    distances[target] = alt;
+    return distances;
+}
+
+
+Distances compute_multi_target_shortest_distances(const RoleDenotation& edges, const ConceptDenotation& targets) {
+    int num_objects = targets.get_num_objects();
+    Distances distances(num_objects, INF);
+    targets.for_each([&](ObjectIndex target) { distances[target] = 0; });
+    ConceptDenotation visited = targets;
+    ConceptDenotation layer = targets;
+    for (int distance = 1; !layer.empty(); ++distance) {
+        layer = edges.get_predecessors(layer);
+        layer -= visited;
+        layer.for_each([&](ObjectIndex source) { distances[source] = distance; });
+        visited |= layer;
+    }
+    return distances;
+}
+
+
+/*
+  Multi-source breadth-first search (MS-BFS) that runs up to 64 backward
+  searches at once. Each object has one word per layer and bit l of it
+  belongs to the search from targets[l]. A layer is expanded with a single
+  pass over the predecessor lists, such that searches on the same graph
+  share the traversal of the edges.
+*/
+PairwiseDistances compute_multi_target_shortest_distances(const RoleDenotation& edges, const std::vector<ConceptDenotation>& targets) {
+    using Lanes = std::uint64_t;
+    const int num_lanes = std::numeric_limits<Lanes>::digits;
+    int num_objects = edges.get_num_objects();
+    PairwiseDistances distances(targets.size(), Distances(num_objects, INF));
+    AdjList predecessors = compute_adjacency_list(edges, false);
+    std::vector<Lanes> visited(num_objects);
+    std::vector<Lanes> layer(num_objects);
+    std::vector<Lanes> next_layer(num_objects);
+    for (std::size_t first_lane = 0; first_lane < targets.size(); first_lane += num_lanes) {
+        std::size_t batch_size = std::min<std::size_t>(num_lanes, targets.size() - first_lane);
+        std::fill(visited.begin(), visited.end(), 0);
+        std::fill(layer.begin(), layer.end(), 0);
+        for (std::size_t lane = 0; lane < batch_size; ++lane) {
+            targets[first_lane + lane].for_each([&](ObjectIndex target) {
+                visited[target] |= Lanes(1) << lane;
+                layer[target] |= Lanes(1) << lane;
+                distances[first_lane + lane][target] = 0;
+            });
+        }
+        bool is_layer_empty = false;
+        for (int distance = 1; !is_layer_empty; ++distance) {
+            std::fill(next_layer.begin(), next_layer.end(), 0);
+            for (int target = 0; target < num_objects; ++target) {
+                if (layer[target]) {
+                    for (int source : predecessors[target]) {
+                        next_layer[source] |= layer[target];
+                    }
                 }
             }
+            is_layer_empty = true;
+            for (int source = 0; source < num_objects; ++source) {
+                Lanes lanes = next_layer[source] & ~visited[source];
+                next_layer[source] = lanes;
+                if (lanes) {
+                    is_layer_empty = false;
+                    visited[source] |= lanes;
+                    for (; lanes; lanes &= lanes - 1) {
+                        int lane = ::dlplan::utils::bitset_detail::count_trailing_zeros(lanes);
+                        distances[first_lane + lane][source] = distance;
+                    }
+                }
+            }
+            std::swap(layer, next_layer);
         }
     }
     return distances;
 }
 
 
+/*
+  One search per object, 64 of which run at once as MS-BFS.
+*/
+DistanceMatrix compute_pairwise_distances(const RoleDenotation& edges) {
+    int num_objects = edges.get_num_objects();
+    std::vector<ConceptDenotation> targets(num_objects, ConceptDenotation(num_objects));
+    for (int target = 0; target < num_objects; ++target) {
+        targets[target].insert(target);
+    }
+    PairwiseDistances target_distances = compute_multi_target_shortest_distances(edges, targets);
+    DistanceMatrix distances(static_cast<std::size_t>(num_objects) * num_objects);
+    for (int source = 0; source < num_objects; ++source) {
+        for (int target = 0; target < num_objects; ++target) {
+            int distance = target_distances[target][source];
+            distances[static_cast<std::size_t>(source) * num_objects + target] = (distance == INF) ? DISTANCE_MATRIX_INF : distance;
+        }
+    }
+    return distances;
+}
+
+
+/*
+  A matrix costs one search per object, which only pays off if the role
+  denotation is reused. Hence, the first request of a role denotation
+  only marks it and the second computes the matrix. Concurrent threads
+  can compute the same matrix, in which case the first one is kept.
+*/
+const DistanceMatrix* get_pairwise_distances(const RoleDenotation* edges, DenotationsCaches& caches) {
+    auto& cache = caches.get_distances_cache();
+    {
+        auto lock = cache.lock();
+        const DistanceMatrix* distances = cache.get_distances(edges);
+        if (distances) {
+            return distances;
+        }
+        if (!cache.can_insert(edges->get_num_objects()) || cache.m_requested.insert(edges).second) {
+            return nullptr;
+        }
+        cache.m_requested.erase(edges);
+    }
+    DistanceMatrix distances = compute_pairwise_distances(*edges);
+    auto lock = cache.lock();
+    return cache.insert_distances(edges, std::move(distances));
+}
+
+
+int compute_multi_source_multi_target_shortest_distance(const ConceptDenotation& sources, const DistanceMatrix& distances, const ConceptDenotation& targets) {
+    std::size_t num_objects = sources.get_num_objects();
+    std::int16_t result = DISTANCE_MATRIX_INF;
+    sources.for_each([&](ObjectIndex source) {
+        const std::int16_t* row = distances.data() + source * num_objects;
+        targets.for_each([&](ObjectIndex target) {
+            result = std::min(result, row[target]);
+        });
+    });
+    return (result == DISTANCE_MATRIX_INF) ? INF : result;
+}
+
+
 PairwiseDistances compute_floyd_warshall(const RoleDenotation& edges) {
     int num_objects = edges.get_num_objects();
     AdjList adj_list = compute_adjacency_list(edges);
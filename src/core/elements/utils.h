@@ -14,6 +14,10 @@ namespace dlplan::core::utils {
 
 using Distances = std::vector<int>;
 using PairwiseDistances = std::vector<Distances>;
+/// Row-major matrix of shortest distances between all pairs of objects.
+using DistanceMatrix = std::vector<std::int16_t>;
+
+const std::int16_t DISTANCE_MATRIX_INF = std::numeric_limits<std::int16_t>::max();
 
 extern int path_addition(int a, int b);
 
@@ -21,6 +25,18 @@ extern int compute_multi_source_multi_target_shortest_distance(const ConceptDeno
 
 extern Distances compute_multi_source_multi_target_shortest_distances(const ConceptDenotation& sources, const RoleDenotation& edges, const ConceptDenotation& targets);
 
+extern Distances compute_multi_target_shortest_distances(const RoleDenotation& edges, const ConceptDenotation& targets);
+
+extern PairwiseDistances compute_multi_target_shortest_distances(const RoleDenotation& edges, const std::vector<ConceptDenotation>& targets);
+
+extern DistanceMatrix compute_pairwise_distances(const RoleDenotation& edges);
+
+/// Returns the cached matrix of the role denotation, or nullptr if it was
+/// requested for the first time or the matrix does not fit into the cache.
+extern const DistanceMatrix* get_pairwise_distances(const RoleDenotation* edges, DenotationsCaches& caches);
+
+extern int compute_multi_source_multi_target_shortest_distance(const ConceptDenotation& sources, const DistanceMatrix& distances, const ConceptDenotation& targets);
+
 extern PairwiseDistances compute_floyd_warshall(const RoleDenotation& edges);
 
 }
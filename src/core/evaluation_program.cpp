@@ -0,0 +1,360 @@
+#include "elements/booleans/empty.h"
+#include "elements/concepts/and.h"
+#include "elements/concepts/some.h"
+#include "elements/numericals/count.h"
+#include "elements/roles/primitive.h"
+
+#include "../../include/dlplan/core.h"
+
+#include <functional>
+#include <stdexcept>
+#include <unordered_map>
+
+
+namespace dlplan::core {
+
+EvaluationOperands::EvaluationOperands(const Operand* begin, const Operand* end, const std::vector<ConceptDenotation>* concept_registers, const std::vector<RoleDenotation>* role_registers)
+    : m_begin(begin), m_end(end), m_concept_registers(concept_registers), m_role_registers(role_registers) { }
+
+int EvaluationOperands::get_register(const BaseElement& element) const {
+    // Elements have at most a handful of children.
+    for (const Operand* operand = m_begin; operand != m_end; ++operand) {
+        if (operand->first == &element) {
+            return operand->second;
+        }
+    }
+    throw std::runtime_error("EvaluationOperands::get_register - element is not a child.");
+}
+
+const ConceptDenotation& EvaluationOperands::get_denotation(const Concept& element) const {
+    return (*m_concept_registers)[get_register(element)];
+}
+
+const RoleDenotation& EvaluationOperands::get_denotation(const Role& element) const {
+    return (*m_role_registers)[get_register(element)];
+}
+
+
+/*
+  Compilation is a depth-first search from the Booleans and Numericals that
+  emits each element after its children. Static elements only have static
+  children, such that the static instructions can run separately before
+  the dynamic ones.
+
+  The fusion pass then replaces common shapes by fused kernels. The inner
+  element of a shape must be dynamic and have no other reader, because its
+  denotation is never materialized.
+
+  Registers of static elements stay allocated. A register of a dynamic
+  element is released after its last reader in the dynamic instructions.
+  The register of the result is allocated before releasing the operands
+  such that an instruction never reads and writes the same register.
+*/
+EvaluationProgram::EvaluationProgram(const std::vector<std::shared_ptr<const Boolean>>& booleans, const std::vector<std::shared_ptr<const Numerical>>& numericals)
+    : m_booleans(booleans), m_numericals(numericals),
+      m_num_concept_registers(0), m_num_role_registers(0),
+      m_boolean_denotations(booleans.size()), m_numerical_denotations(numericals.size()) {
+    struct Node {
+        const BaseElement* element;
+        ElementType type;
+        std::vector<int> children;
+        Kernel kernel;
+        const BaseElement* primitive;
+        int num_readers;
+        bool is_fused;
+        int result;
+        int last_reader;
+    };
+    std::vector<Node> nodes;
+    std::unordered_map<const BaseElement*, int> element_to_node;
+    std::function<int(const BaseElement*, ElementType)> add_node = [&](const BaseElement* element, ElementType type) {
+        std::vector<int> children;
+        for (const BaseElement* child : element->get_children()) {
+            auto it = element_to_node.find(child);
+            if (it != element_to_node.end()) {
+                children.push_back(it->second);
+            } else if (dynamic_cast<const Concept*>(child)) {
+                children.push_back(add_node(child, ElementType::CONCEPT));
+            } else if (dynamic_cast<const Role*>(child)) {
+                children.push_back(add_node(child, ElementType::ROLE));
+            } else {
+                throw std::runtime_error("EvaluationProgram::EvaluationProgram - child is not of type Concept or Role.");
+            }
+        }
+        nodes.push_back(Node{element, type, std::move(children), Kernel::ELEMENT, nullptr, 0, false, -1, -1});
+        element_to_node.emplace(element, nodes.size() - 1);
+        return static_cast<int>(nodes.size() - 1);
+    };
+    // Booleans and Numericals are never children and get one output each.
+    for (const auto& boolean : m_booleans) {
+        add_node(boolean.get(), ElementType::BOOLEAN);
+    }
+    for (const auto& numerical : m_numericals) {
+        add_node(numerical.get(), ElementType::NUMERICAL);
+    }
+    for (const auto& node : nodes) {
+        for (int child : node.children) {
+            ++nodes[child].num_readers;
+        }
+    }
+    auto is_fusable = [&](int index) {
+        return nodes[index].num_readers == 1 && !nodes[index].element->is_static();
+    };
+    // Children precede their parents, so inner shapes are fused first.
+    for (auto& node : nodes) {
+        if (dynamic_cast<const SomeConcept*>(node.element)) {
+            int role = node.children[0];
+            if (is_fusable(role) && dynamic_cast<const PrimitiveRole*>(nodes[role].element)) {
+                nodes[role].is_fused = true;
+                node.kernel = Kernel::SOME_PRIMITIVE;
+                node.primitive = nodes[role].element;
+                node.children = {node.children[1]};
+            }
+            continue;
+        }
+        bool is_count = dynamic_cast<const CountNumerical<Concept>*>(node.element);
+        bool is_empty = dynamic_cast<const EmptyBoolean<Concept>*>(node.element);
+        if (!(is_count || is_empty) || !is_fusable(node.children[0])) continue;
+        Node& child_node = nodes[node.children[0]];
+        if (dynamic_cast<const AndConcept*>(child_node.element)) {
+            node.kernel = is_count ? Kernel::COUNT_AND : Kernel::EMPTY_AND;
+        } else if (dynamic_cast<const SomeConcept*>(child_node.element)) {
+            if (child_node.kernel == Kernel::SOME_PRIMITIVE) {
+                // Counting requires the distinct objects of the concept.
+                if (is_count) continue;
+                node.kernel = Kernel::EMPTY_SOME_PRIMITIVE;
+                node.primitive = child_node.primitive;
+            } else {
+                node.kernel = is_count ? Kernel::COUNT_SOME : Kernel::EMPTY_SOME;
+            }
+        } else {
+            continue;
+        }
+        child_node.is_fused = true;
+        node.children = child_node.children;
+    }
+    int position = 0;
+    for (const auto& node : nodes) {
+        if (node.is_fused || node.element->is_static()) continue;
+        for (int child : node.children) {
+            nodes[child].last_reader = position;
+        }
+        ++position;
+    }
+    std::vector<int> free_concept_registers;
+    std::vector<int> free_role_registers;
+    int num_booleans = 0;
+    int num_numericals = 0;
+    position = 0;
+    for (auto& node : nodes) {
+        if (node.is_fused) continue;
+        bool is_static = node.element->is_static();
+        if (node.type == ElementType::BOOLEAN) {
+            node.result = num_booleans++;
+        } else if (node.type == ElementType::NUMERICAL) {
+            node.result = num_numericals++;
+        } else {
+            auto& free_registers = (node.type == ElementType::CONCEPT) ? free_concept_registers : free_role_registers;
+            int& num_registers = (node.type == ElementType::CONCEPT) ? m_num_concept_registers : m_num_role_registers;
+            if (!is_static && !free_registers.empty()) {
+                node.result = free_registers.back();
+                free_registers.pop_back();
+            } else {
+                node.result = num_registers++;
+            }
+        }
+        Instruction instruction{node.element, node.type, node.kernel, node.primitive, node.result,
+            static_cast<int>(m_operands.size()), static_cast<int>(m_operands.size() + node.children.size())};
+        for (int child : node.children) {
+            m_operands.emplace_back(nodes[child].element, nodes[child].result);
+        }
+        if (is_static) {
+            m_static_instructions.push_back(instruction);
+            continue;
+        }
+        m_dynamic_instructions.push_back(instruction);
+        for (int child : node.children) {
+            Node& child_node = nodes[child];
+            if (!child_node.element->is_static() && child_node.last_reader == position) {
+                // Release once even if the child occurs twice as operand.
+                child_node.last_reader = -1;
+                ((child_node.type == ElementType::CONCEPT) ? free_concept_registers : free_role_registers).push_back(child_node.result);
+            }
+        }
+        ++position;
+    }
+}
+
+EvaluationProgram::EvaluationProgram(const EvaluationProgram& other) = default;
+
+EvaluationProgram& EvaluationProgram::operator=(const EvaluationProgram& other) = default;
+
+EvaluationProgram::EvaluationProgram(EvaluationProgram&& other) = default;
+
+EvaluationProgram& EvaluationProgram::operator=(EvaluationProgram&& other) = default;
+
+EvaluationProgram::~EvaluationProgram() = default;
+
+void EvaluationProgram::execute(const Instruction& instruction, const State& state) {
+    const EvaluationOperands::Operand* operands_begin = m_operands.data() + instruction.operands_begin;
+    const EvaluationOperands::Operand* operands_end = m_operands.data() + instruction.operands_end;
+    switch (instruction.kernel) {
+        case Kernel::ELEMENT:
+            break;
+        case Kernel::SOME_PRIMITIVE: {
+            ConceptDenotation& result = m_concept_registers[instruction.result];
+            result.clear();
+            const ConceptDenotation& targets = m_concept_registers[operands_begin[0].second];
+            static_cast<const PrimitiveRole*>(instruction.primitive)->for_each_pair(state, [&](const PairOfObjectIndices& pair) {
+                if (targets.contains(pair.second)) result.insert(pair.first);
+                return true;
+            });
+            return;
+        }
+        case Kernel::COUNT_SOME: {
+            const RoleDenotation& role = m_role_registers[operands_begin[0].second];
+            const ConceptDenotation& targets = m_concept_registers[operands_begin[1].second];
+            int count = 0;
+            for (int source = 0; source < role.get_num_objects(); ++source) {
+                if (role.successors_intersect(source, targets)) ++count;
+            }
+            m_numerical_denotations[instruction.result] = count;
+            return;
+        }
+        case Kernel::COUNT_AND: {
+            m_numerical_denotations[instruction.result] = m_concept_registers[operands_begin[0].second].intersection_size(
+                m_concept_registers[operands_begin[1].second]);
+            return;
+        }
+        case Kernel::EMPTY_SOME: {
+            const RoleDenotation& role = m_role_registers[operands_begin[0].second];
+            const ConceptDenotation& targets = m_concept_registers[operands_begin[1].second];
+            bool empty = true;
+            for (int source = 0; source < role.get_num_objects() && empty; ++source) {
+                empty = !role.successors_intersect(source, targets);
+            }
+            m_boolean_denotations[instruction.result] = empty;
+            return;
+        }
+        case Kernel::EMPTY_SOME_PRIMITIVE: {
+            const ConceptDenotation& targets = m_concept_registers[operands_begin[0].second];
+            m_boolean_denotations[instruction.result] = static_cast<const PrimitiveRole*>(instruction.primitive)->for_each_pair(state, [&](const PairOfObjectIndices& pair) {
+                return !targets.contains(pair.second);
+            });
+            return;
+        }
+        case Kernel::EMPTY_AND: {
+            m_boolean_denotations[instruction.result] = !m_concept_registers[operands_begin[0].second].intersects(
+                m_concept_registers[operands_begin[1].second]);
+            return;
+        }
+    }
+    EvaluationOperands operands(operands_begin, operands_end, &m_concept_registers, &m_role_registers);
+    switch (instruction.type) {
+        case ElementType::CONCEPT: {
+            ConceptDenotation& result = m_concept_registers[instruction.result];
+            result.clear();
+            static_cast<const Concept*>(instruction.element)->evaluate_impl(state, operands, result);
+            break;
+        }
+        case ElementType::ROLE: {
+            RoleDenotation& result = m_role_registers[instruction.result];
+            result.clear();
+            static_cast<const Role*>(instruction.element)->evaluate_impl(state, operands, result);
+            break;
+        }
+        case ElementType::BOOLEAN: {
+            m_boolean_denotations[instruction.result] = static_cast<const Boolean*>(instruction.element)->evaluate_impl(state, operands);
+            break;
+        }
+        case ElementType::NUMERICAL: {
+            m_numerical_denotations[instruction.result] = static_cast<const Numerical*>(instruction.element)->evaluate_impl(state, operands);
+            break;
+        }
+    }
+}
+
+void EvaluationProgram::evaluate(const State& state) {
+    if (state.get_instance_info() != m_instance_info) {
+        m_instance_info = state.get_instance_info();
+        int num_objects = m_instance_info->get_objects().size();
+        m_concept_registers.assign(m_num_concept_registers, ConceptDenotation(num_objects));
+        m_role_registers.assign(m_num_role_registers, RoleDenotation(num_objects));
+        for (const auto& instruction : m_static_instructions) {
+            execute(instruction, state);
+        }
+    }
+    for (const auto& instruction : m_dynamic_instructions) {
+        execute(instruction, state);
+    }
+}
+
+/*
+  The outputs are looked up until the first one that is missing, in which
+  case the program runs on the state. If the program is skipped on a state
+  of another instance, the outputs of static elements belong to that
+  instance, so the static instructions run again on the next execution.
+*/
+void EvaluationProgram::evaluate(const State& state, DenotationsCaches& caches) {
+    if (state.get_index() < 0) {
+        evaluate(state);
+        return;
+    }
+    DenotationsCaches::EvaluationGuard guard(caches);
+    InstanceIndex instance = state.get_instance_info()->get_index();
+    auto& boolean_cache = caches.get_boolean_denotation_cache();
+    auto& numerical_cache = caches.get_numerical_denotation_cache();
+    auto find_denotation = [&](const auto& element, auto& cache, auto& denotation) {
+        StateIndex index = element.is_static() ? -1 : state.get_index();
+        const auto* cached = cache.get_denotation(element.get_index(), instance, index);
+        if (cached) {
+            denotation = *cached;
+            return true;
+        }
+        if (caches.find_stored_denotation(element, state, denotation)) {
+            cache.insert_denotation(element.get_index(), instance, index, std::move(denotation));
+            return true;
+        }
+        return false;
+    };
+    bool is_complete = true;
+    for (std::size_t i = 0; i < m_booleans.size() && is_complete; ++i) {
+        bool denotation = false;
+        is_complete = find_denotation(*m_booleans[i], boolean_cache, denotation);
+        m_boolean_denotations[i] = denotation;
+    }
+    for (std::size_t i = 0; i < m_numericals.size() && is_complete; ++i) {
+        is_complete = find_denotation(*m_numericals[i], numerical_cache, m_numerical_denotations[i]);
+    }
+    if (is_complete) {
+        if (state.get_instance_info() != m_instance_info) {
+            m_instance_info = nullptr;
+        }
+        return;
+    }
+    evaluate(state);
+    for (std::size_t i = 0; i < m_booleans.size(); ++i) {
+        boolean_cache.insert_denotation(m_booleans[i]->get_index(), instance, m_booleans[i]->is_static() ? -1 : state.get_index(), bool(m_boolean_denotations[i]));
+    }
+    for (std::size_t i = 0; i < m_numericals.size(); ++i) {
+        numerical_cache.insert_denotation(m_numericals[i]->get_index(), instance, m_numericals[i]->is_static() ? -1 : state.get_index(), int(m_numerical_denotations[i]));
+    }
+}
+
+const BooleanDenotations& EvaluationProgram::get_boolean_denotations() const {
+    return m_boolean_denotations;
+}
+
+const NumericalDenotations& EvaluationProgram::get_numerical_denotations() const {
+    return m_numerical_denotations;
+}
+
+int EvaluationProgram::get_num_instructions() const {
+    return m_static_instructions.size() + m_dynamic_instructions.size();
+}
+
+int EvaluationProgram::get_num_registers() const {
+    return m_num_concept_registers + m_num_role_registers;
+}
+
+}
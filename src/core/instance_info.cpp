@@ -63,6 +63,10 @@ const Atom& InstanceInfo::add_atom(const Predicate& predicate, const std::vector
         if (!newly_inserted) {
             throw std::runtime_error("InstanceInfo::add_atom - atom with name ("s + atom.get_name() + ") already exists.");
         }
+        if (static_cast<int>(m_static_atom_indices_by_predicate.size()) <= predicate.get_index()) {
+            m_static_atom_indices_by_predicate.resize(predicate.get_index() + 1);
+        }
+        m_static_atom_indices_by_predicate[predicate.get_index()].push_back(atom.get_index());
         m_static_atoms.push_back(std::move(atom));
         return m_static_atoms.back();
     } else {
@@ -166,6 +170,14 @@ const std::vector<Atom>& InstanceInfo::get_static_atoms() const {
     return m_static_atoms;
 }
 
+const AtomIndices& InstanceInfo::get_static_atom_indices(PredicateIndex predicate_index) const {
+    static const AtomIndices empty;
+    if (predicate_index < 0 || predicate_index >= static_cast<int>(m_static_atom_indices_by_predicate.size())) {
+        return empty;
+    }
+    return m_static_atom_indices_by_predicate[predicate_index];
+}
+
 const std::vector<Object>& InstanceInfo::get_objects() const {
     return m_objects;
 }
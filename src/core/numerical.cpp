@@ -19,24 +19,54 @@ Numerical& Numerical::operator=(Numerical&& other) = default;
 Numerical::~Numerical() = default;
 
 int Numerical::evaluate(const State& state, DenotationsCaches& caches) const {
+    DenotationsCaches::EvaluationGuard guard(caches);
     const int* cached = caches.get_numerical_denotation_cache().get_denotation(
         get_index(),
         state.get_instance_info()->get_index(),
         is_static() ? -1 : state.get_index());
     if (cached) return *cached;
-    const int* denotation = caches.get_numerical_denotation_cache().insert_denotation(evaluate_impl(state, caches));
-    caches.get_numerical_denotation_cache().insert_denotation(
+    // Denotations of a previous run are inserted instead of computed.
+    int stored = 0;
+    bool is_stored = caches.find_stored_denotation(*this, state, stored);
+    const int* denotation = caches.get_numerical_denotation_cache().insert_denotation(
         get_index(),
         state.get_instance_info()->get_index(),
         is_static() ? -1 : state.get_index(),
-        denotation);
+        is_stored ? std::move(stored) : evaluate_impl(state, caches));
     return *denotation;
 }
 
+/*
+  A static element has the same denotation in all states of an instance.
+  It is evaluated once per instance and all states share the result.
+*/
+static NumericalDenotations evaluate_static(const Numerical& element, const States& states, DenotationsCaches& caches) {
+    NumericalDenotations denotations;
+    denotations.reserve(states.size());
+    const InstanceInfo* instance_info = nullptr;
+    int denotation = 0;
+    for (const auto& state : states) {
+        if (state.get_instance_info().get() != instance_info) {
+            instance_info = state.get_instance_info().get();
+            denotation = element.evaluate(state, caches);
+        }
+        denotations.push_back(denotation);
+    }
+    return denotations;
+}
+
 const NumericalDenotations* Numerical::evaluate(const States& states, DenotationsCaches& caches) const {
+    DenotationsCaches::EvaluationGuard guard(caches);
     auto cached = caches.get_numerical_denotations_cache().get_denotation(get_index(), -1, -1);
     if (cached) return cached;
-    auto result_denotations = caches.get_numerical_denotations_cache().insert_denotation(evaluate_impl(states, caches));
+    // Denotations of dynamic elements are read from the loaded file if it has all.
+    NumericalDenotations denotations;
+    if (is_static()) {
+        denotations = evaluate_static(*this, states, caches);
+    } else if (!caches.find_stored_denotations(*this, states, denotations)) {
+        denotations = evaluate_impl(states, caches);
+    }
+    auto result_denotations = caches.get_numerical_denotations_cache().insert_denotation(std::move(denotations));
     caches.get_numerical_denotations_cache().insert_denotation(get_index(), -1, -1, result_denotations);
     return result_denotations;
 }
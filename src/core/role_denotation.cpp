@@ -1,19 +1,60 @@
 #include "../../include/dlplan/core.h"
 #include "../../include/dlplan/utils/hash.h"
+#include "../../include/dlplan/utils/bitset_kernels.h"
 
 #include "../utils/logging.h"
 
+#include <algorithm>
+#include <iterator>
+#include <numeric>
 #include <sstream>
 
 
 namespace dlplan::core {
 
-RoleDenotation::RoleDenotation(int num_objects)
-    : m_num_objects(num_objects), m_data(utils::DynamicBitset<unsigned>(num_objects * num_objects)) { }
+using Block = std::uint64_t;
+using Bitset = utils::DynamicBitset<Block>;
 
-RoleDenotation::RoleDenotation(const RoleDenotation& other) = default;
+static int compute_row_size(int num_objects) {
+    return ((num_objects + Bitset::bits_per_block - 1) / Bitset::bits_per_block) * Bitset::bits_per_block;
+}
 
-RoleDenotation& RoleDenotation::operator=(const RoleDenotation& other) = default;
+RoleDenotation::RoleDenotation(int num_objects)
+    : m_num_objects(num_objects),
+      m_row_size(compute_row_size(num_objects)),
+      m_size(0),
+      m_is_dense(false),
+      m_data(Bitset(0)),
+      m_has_hash(false),
+      m_hash(0) { }
+
+// The transpose is loaded atomically because another thread can compute it
+// for a cached denotation while it is copied.
+RoleDenotation::RoleDenotation(const RoleDenotation& other)
+    : m_num_objects(other.m_num_objects),
+      m_row_size(other.m_row_size),
+      m_size(other.m_size),
+      m_is_dense(other.m_is_dense),
+      m_pairs(other.m_pairs),
+      m_data(other.m_data),
+      m_has_hash(other.m_has_hash),
+      m_hash(other.m_hash),
+      m_transpose(std::atomic_load(&other.m_transpose)) { }
+
+RoleDenotation& RoleDenotation::operator=(const RoleDenotation& other) {
+    if (this != &other) {
+        m_num_objects = other.m_num_objects;
+        m_row_size = other.m_row_size;
+        m_size = other.m_size;
+        m_is_dense = other.m_is_dense;
+        m_pairs = other.m_pairs;
+        m_data = other.m_data;
+        m_has_hash = other.m_has_hash;
+        m_hash = other.m_hash;
+        m_transpose = std::atomic_load(&other.m_transpose);
+    }
+    return *this;
+}
 
 RoleDenotation::RoleDenotation(RoleDenotation&& other) = default;
 
@@ -21,9 +62,154 @@ RoleDenotation& RoleDenotation::operator=(RoleDenotation&& other) = default;
 
 RoleDenotation::~RoleDenotation() = default;
 
+std::size_t RoleDenotation::compute_position(ObjectIndex source, ObjectIndex target) const {
+    return static_cast<std::size_t>(source) * m_row_size + target;
+}
+
+std::size_t RoleDenotation::get_num_blocks_per_row() const {
+    return m_row_size / Bitset::bits_per_block;
+}
+
+const Block* RoleDenotation::get_row(ObjectIndex source) const {
+    return m_data.data() + source * get_num_blocks_per_row();
+}
+
+PairsOfObjectIndices::const_iterator RoleDenotation::get_row_begin(ObjectIndex source) const {
+    return std::lower_bound(m_pairs.begin(), m_pairs.end(), PairOfObjectIndices(source, 0));
+}
+
+PairsOfObjectIndices::const_iterator RoleDenotation::get_row_end(ObjectIndex source) const {
+    return std::lower_bound(m_pairs.begin(), m_pairs.end(), PairOfObjectIndices(source + 1, 0));
+}
+
+const Bitset& RoleDenotation::get_transpose() const {
+    // Cached denotations are shared by threads with concurrent caches.
+    // If threads compute the transpose at once, the first one is stored
+    // and never replaced, such that returned references remain valid.
+    std::shared_ptr<const Bitset> result = std::atomic_load(&m_transpose);
+    if (!result) {
+        auto transpose = std::make_shared<Bitset>(m_data.size());
+        for_each([&](ObjectIndex a, ObjectIndex b) {
+            transpose->set(compute_position(b, a));
+        });
+        std::shared_ptr<const Bitset> desired = std::move(transpose);
+        if (std::atomic_compare_exchange_strong(&m_transpose, &result, desired)) {
+            result = std::move(desired);
+        }
+    }
+    return *result;
+}
+
+ObjectIndices RoleDenotation::get_sorted_successors(ObjectIndex source) const {
+    ObjectIndices result;
+    if (!m_is_dense) {
+        for (auto it = get_row_begin(source); it != m_pairs.end() && it->first == source; ++it) {
+            result.push_back(it->second);
+        }
+        return result;
+    }
+    const Block* row = get_row(source);
+    for (std::size_t i = 0; i < get_num_blocks_per_row(); ++i) {
+        for (Block block = row[i]; block; block &= block - 1) {
+            result.push_back(i * Bitset::bits_per_block + utils::bitset_detail::count_trailing_zeros(block));
+        }
+    }
+    return result;
+}
+
+void RoleDenotation::insert_pairs(ObjectIndex source, const ObjectIndices& targets) {
+    if (m_is_dense) {
+        for (ObjectIndex target : targets) {
+            auto pos = compute_position(source, target);
+            if (!m_data.test(pos)) {
+                m_data.set(pos);
+                ++m_size;
+            }
+        }
+    } else {
+        PairsOfObjectIndices row;
+        row.reserve(targets.size());
+        for (ObjectIndex target : targets) {
+            row.emplace_back(source, target);
+        }
+        PairsOfObjectIndices result;
+        result.reserve(m_pairs.size() + row.size());
+        std::set_union(m_pairs.begin(), m_pairs.end(), row.begin(), row.end(), std::back_inserter(result));
+        m_pairs = std::move(result);
+        m_size = m_pairs.size();
+    }
+    update_representation();
+    invalidate_caches();
+}
+
+void RoleDenotation::zero_padding_bits() {
+    int num_padding_bits = m_row_size - m_num_objects;
+    if (num_padding_bits == 0) {
+        return;
+    }
+    Block mask = ~Block(0) >> num_padding_bits;
+    std::size_t num_blocks_per_row = get_num_blocks_per_row();
+    Block* data = m_data.data();
+    for (int source = 0; source < m_num_objects; ++source) {
+        data[(source + 1) * num_blocks_per_row - 1] &= mask;
+    }
+    m_data.recompute_hash();
+}
+
+void RoleDenotation::invalidate_caches() {
+    m_has_hash = false;
+    m_transpose.reset();
+}
+
+/*
+  A pair in the sorted vector takes 64 bits. We keep the sorted vector as long
+  as it uses at most 1/8 of the memory of the bit matrix. Below that bound,
+  linear scans over the pairs are also cheaper than word-parallel operations
+  over all blocks of the bit matrix.
+*/
+int RoleDenotation::get_max_sparse_size() const {
+    return static_cast<int>(static_cast<std::size_t>(m_num_objects) * m_row_size / 512);
+}
+
+void RoleDenotation::convert_to_dense() {
+    Bitset data(static_cast<std::size_t>(m_num_objects) * m_row_size);
+    for (const auto& pair : m_pairs) {
+        data.set(compute_position(pair.first, pair.second));
+    }
+    m_data = std::move(data);
+    PairsOfObjectIndices().swap(m_pairs);
+    m_is_dense = true;
+}
+
+void RoleDenotation::convert_to_sparse() {
+    PairsOfObjectIndices pairs;
+    pairs.reserve(m_size);
+    for (auto pos = m_data.find_first(); pos != m_data.npos; pos = m_data.find_next(pos)) {
+        pairs.emplace_back(pos / m_row_size, pos % m_row_size);
+    }
+    m_pairs = std::move(pairs);
+    m_data = Bitset(0);
+    m_is_dense = false;
+}
+
+void RoleDenotation::update_representation() {
+    if (m_is_dense && m_size <= get_max_sparse_size()) {
+        convert_to_sparse();
+    } else if (!m_is_dense && m_size > get_max_sparse_size()) {
+        convert_to_dense();
+    }
+}
+
 bool RoleDenotation::operator==(const RoleDenotation& other) const {
     if (this != &other) {
-        return this->m_data == other.m_data;
+        if (m_num_objects != other.m_num_objects || m_size != other.m_size) {
+            return false;
+        }
+        // Both have the same representation because it depends on the size only.
+        if (m_is_dense) {
+            return m_data == other.m_data;
+        }
+        return m_pairs == other.m_pairs;
     }
     return true;
 }
@@ -33,55 +219,186 @@ bool RoleDenotation::operator!=(const RoleDenotation& other) const {
 }
 
 RoleDenotation& RoleDenotation::operator&=(const RoleDenotation& other) {
-    m_data &= other.m_data;
+    if (!m_is_dense) {
+        m_pairs.erase(std::remove_if(m_pairs.begin(), m_pairs.end(),
+            [&](const PairOfObjectIndices& pair) { return !other.contains(pair); }), m_pairs.end());
+        m_size = m_pairs.size();
+    } else if (!other.m_is_dense) {
+        PairsOfObjectIndices pairs;
+        for (const auto& pair : other.m_pairs) {
+            if (contains(pair)) {
+                pairs.push_back(pair);
+            }
+        }
+        m_pairs = std::move(pairs);
+        m_data = Bitset(0);
+        m_is_dense = false;
+        m_size = m_pairs.size();
+    } else {
+        m_data &= other.m_data;
+        m_size = m_data.count();
+    }
+    update_representation();
+    invalidate_caches();
     return *this;
 }
 
 RoleDenotation& RoleDenotation::operator|=(const RoleDenotation& other) {
-    m_data |= other.m_data;
+    if (!m_is_dense && !other.m_is_dense) {
+        PairsOfObjectIndices pairs;
+        pairs.reserve(m_pairs.size() + other.m_pairs.size());
+        std::set_union(m_pairs.begin(), m_pairs.end(), other.m_pairs.begin(), other.m_pairs.end(), std::back_inserter(pairs));
+        m_pairs = std::move(pairs);
+        m_size = m_pairs.size();
+    } else {
+        if (!m_is_dense) {
+            convert_to_dense();
+        }
+        if (other.m_is_dense) {
+            m_data |= other.m_data;
+        } else {
+            for (const auto& pair : other.m_pairs) {
+                m_data.set(compute_position(pair.first, pair.second));
+            }
+        }
+        m_size = m_data.count();
+    }
+    update_representation();
+    invalidate_caches();
     return *this;
 }
 
 RoleDenotation& RoleDenotation::operator-=(const RoleDenotation& other) {
-    m_data -= other.m_data;
+    if (!m_is_dense) {
+        m_pairs.erase(std::remove_if(m_pairs.begin(), m_pairs.end(),
+            [&](const PairOfObjectIndices& pair) { return other.contains(pair); }), m_pairs.end());
+        m_size = m_pairs.size();
+    } else {
+        if (other.m_is_dense) {
+            m_data -= other.m_data;
+        } else {
+            for (const auto& pair : other.m_pairs) {
+                m_data.reset(compute_position(pair.first, pair.second));
+            }
+        }
+        m_size = m_data.count();
+    }
+    update_representation();
+    invalidate_caches();
     return *this;
 }
 
 RoleDenotation& RoleDenotation::operator~() {
+    if (!m_is_dense) {
+        convert_to_dense();
+    }
     ~m_data;
+    zero_padding_bits();
+    m_size = m_num_objects * m_num_objects - m_size;
+    update_representation();
+    invalidate_caches();
     return *this;
 }
 
 void RoleDenotation::set() {
+    if (!m_is_dense) {
+        convert_to_dense();
+    }
     m_data.set();
+    zero_padding_bits();
+    m_size = m_num_objects * m_num_objects;
+    update_representation();
+    invalidate_caches();
+}
+
+void RoleDenotation::clear() {
+    m_pairs.clear();
+    if (m_is_dense) {
+        m_data = Bitset(0);
+        m_is_dense = false;
+    }
+    m_size = 0;
+    invalidate_caches();
 }
 
 bool RoleDenotation::contains(const PairOfObjectIndices& value) const {
-    return m_data.test(value.first * m_num_objects + value.second);
+    if (!m_is_dense) {
+        return std::binary_search(m_pairs.begin(), m_pairs.end(), value);
+    }
+    return m_data.test(compute_position(value.first, value.second));
 }
 
 void RoleDenotation::insert(const PairOfObjectIndices& value) {
-    return m_data.set(value.first * m_num_objects + value.second);
+    if (!m_is_dense) {
+        auto it = std::lower_bound(m_pairs.begin(), m_pairs.end(), value);
+        if (it == m_pairs.end() || *it != value) {
+            m_pairs.insert(it, value);
+            ++m_size;
+        }
+    } else {
+        auto pos = compute_position(value.first, value.second);
+        if (!m_data.test(pos)) {
+            m_data.set(pos);
+            ++m_size;
+        }
+    }
+    update_representation();
+    invalidate_caches();
 }
 
 void RoleDenotation::erase(const PairOfObjectIndices& value) {
-    return m_data.reset(value.first * m_num_objects + value.second);
+    if (!m_is_dense) {
+        auto it = std::lower_bound(m_pairs.begin(), m_pairs.end(), value);
+        if (it != m_pairs.end() && *it == value) {
+            m_pairs.erase(it);
+            --m_size;
+        }
+    } else {
+        auto pos = compute_position(value.first, value.second);
+        if (m_data.test(pos)) {
+            m_data.reset(pos);
+            --m_size;
+        }
+    }
+    update_representation();
+    invalidate_caches();
 }
 
 int RoleDenotation::size() const {
-    return m_data.count();
+    return m_size;
 }
 
 bool RoleDenotation::empty() const {
-    return m_data.none();
+    return m_size == 0;
 }
 
 bool RoleDenotation::intersects(const RoleDenotation& other) const {
-    return m_data.intersects(other.m_data);
+    if (m_is_dense && other.m_is_dense) {
+        return m_data.intersects(other.m_data);
+    }
+    const RoleDenotation& sparse = m_is_dense ? other : *this;
+    const RoleDenotation& dense = m_is_dense ? *this : other;
+    for (const auto& pair : sparse.m_pairs) {
+        if (dense.contains(pair)) {
+            return true;
+        }
+    }
+    return false;
 }
 
 bool RoleDenotation::is_subset_of(const RoleDenotation& other) const {
-    return m_data.is_subset_of(other.m_data);
+    if (m_size > other.m_size) {
+        return false;
+    }
+    if (m_is_dense && other.m_is_dense) {
+        return m_data.is_subset_of(other.m_data);
+    }
+    for (const auto pair : *this) {
+        if (!other.contains(pair)) {
+            return false;
+        }
+    }
+    return true;
 }
 
 std::string RoleDenotation::compute_repr() const {
@@ -108,26 +425,360 @@ PairsOfObjectIndices RoleDenotation::to_vector() const {
 }
 
 PairsOfObjectIndices RoleDenotation::to_sorted_vector() const {
+    if (!m_is_dense) {
+        return m_pairs;
+    }
     PairsOfObjectIndices result;
-    result.reserve(m_num_objects * m_num_objects);
-    for (ObjectIndex i = 0; i < m_num_objects; ++i) {
-        int offset = m_num_objects * i;
-        for (ObjectIndex j = 0; j < m_num_objects; ++j) {
-            if (m_data.test(offset + j)) {
-                result.emplace_back(i, j);
-            }
-        }
+    result.reserve(m_size);
+    for (auto pos = m_data.find_first(); pos != m_data.npos; pos = m_data.find_next(pos)) {
+        result.emplace_back(pos / m_row_size, pos % m_row_size);
     }
-    result.shrink_to_fit();
     return result;
 }
 
 std::size_t RoleDenotation::hash() const {
-    return m_data.hash();
+    if (!m_has_hash) {
+        m_hash = m_is_dense
+            ? m_data.hash()
+            : utils::hash_bytes(m_pairs.data(), m_pairs.size() * sizeof(PairOfObjectIndices), m_pairs.size());
+        m_has_hash = true;
+    }
+    return m_hash;
 }
 
 int RoleDenotation::get_num_objects() const {
     return m_num_objects;
 }
 
+ConceptDenotation RoleDenotation::get_successors(ObjectIndex source) const {
+    ConceptDenotation result(m_num_objects);
+    if (!m_is_dense) {
+        for (auto it = get_row_begin(source); it != m_pairs.end() && it->first == source; ++it) {
+            result.insert(it->second);
+        }
+        return result;
+    }
+    std::copy_n(get_row(source), get_num_blocks_per_row(), result.m_data.data());
+    return result;
+}
+
+ConceptDenotation RoleDenotation::get_successors(const ConceptDenotation& sources) const {
+    ConceptDenotation result(m_num_objects);
+    if (!m_is_dense) {
+        for (const auto& pair : m_pairs) {
+            if (sources.contains(pair.first)) {
+                result.insert(pair.second);
+            }
+        }
+        return result;
+    }
+    std::size_t num_blocks = get_num_blocks_per_row();
+    sources.for_each([&](ObjectIndex source) {
+        result.m_data.or_assign(0, get_row(source), num_blocks);
+    });
+    return result;
+}
+
+ConceptDenotation RoleDenotation::get_predecessors(ObjectIndex target) const {
+    ConceptDenotation result(m_num_objects);
+    if (!m_is_dense) {
+        for (const auto& pair : m_pairs) {
+            if (pair.second == target) {
+                result.insert(pair.first);
+            }
+        }
+        return result;
+    }
+    std::copy_n(get_transpose().data() + target * get_num_blocks_per_row(), get_num_blocks_per_row(), result.m_data.data());
+    return result;
+}
+
+ConceptDenotation RoleDenotation::get_predecessors(const ConceptDenotation& targets) const {
+    ConceptDenotation result(m_num_objects);
+    if (!m_is_dense) {
+        for (const auto& pair : m_pairs) {
+            if (targets.contains(pair.second)) {
+                result.insert(pair.first);
+            }
+        }
+        return result;
+    }
+    const Bitset& transpose = get_transpose();
+    std::size_t num_blocks = get_num_blocks_per_row();
+    targets.for_each([&](ObjectIndex target) {
+        result.m_data.or_assign(0, transpose.data() + target * num_blocks, num_blocks);
+    });
+    return result;
+}
+
+/*
+  The read-only row operations below use the vectorized kernels for long
+  rows and inlined loops for short rows, where the call overhead dominates.
+*/
+
+bool RoleDenotation::has_successors(ObjectIndex source) const {
+    if (!m_is_dense) {
+        auto it = get_row_begin(source);
+        return it != m_pairs.end() && it->first == source;
+    }
+    const Block* row = get_row(source);
+    std::size_t num_blocks = get_num_blocks_per_row();
+    for (std::size_t i = 0; i < num_blocks; ++i) {
+        if (row[i]) return true;
+    }
+    return false;
+}
+
+bool RoleDenotation::successors_intersect(ObjectIndex source, const ConceptDenotation& targets) const {
+    if (!m_is_dense) {
+        for (auto it = get_row_begin(source); it != m_pairs.end() && it->first == source; ++it) {
+            if (targets.contains(it->second)) return true;
+        }
+        return false;
+    }
+    const Block* row = get_row(source);
+    const Block* other = targets.m_data.data();
+    std::size_t num_blocks = get_num_blocks_per_row();
+    if (num_blocks >= utils::bitset_kernels::MIN_NUM_BLOCKS) {
+        return utils::bitset_kernels::intersects(row, other, num_blocks);
+    }
+    for (std::size_t i = 0; i < num_blocks; ++i) {
+        if (row[i] & other[i]) return true;
+    }
+    return false;
+}
+
+bool RoleDenotation::successors_are_subset_of(ObjectIndex source, const ConceptDenotation& targets) const {
+    if (!m_is_dense) {
+        for (auto it = get_row_begin(source); it != m_pairs.end() && it->first == source; ++it) {
+            if (!targets.contains(it->second)) return false;
+        }
+        return true;
+    }
+    const Block* row = get_row(source);
+    const Block* other = targets.m_data.data();
+    std::size_t num_blocks = get_num_blocks_per_row();
+    if (num_blocks >= utils::bitset_kernels::MIN_NUM_BLOCKS) {
+        return utils::bitset_kernels::is_subset_of(row, other, num_blocks);
+    }
+    for (std::size_t i = 0; i < num_blocks; ++i) {
+        if (row[i] & ~other[i]) return false;
+    }
+    return true;
+}
+
+void RoleDenotation::insert_successors(ObjectIndex source, const ConceptDenotation& targets) {
+    if (!m_is_dense) {
+        insert_pairs(source, targets.to_sorted_vector());
+        return;
+    }
+    std::size_t num_blocks = get_num_blocks_per_row();
+    std::size_t first_block = source * num_blocks;
+    m_size -= m_data.count(first_block, num_blocks);
+    m_data.or_assign(first_block, targets.m_data.data(), num_blocks);
+    m_size += m_data.count(first_block, num_blocks);
+    invalidate_caches();
+}
+
+void RoleDenotation::insert_successors(ObjectIndex source, const RoleDenotation& other, ObjectIndex other_source) {
+    if (!m_is_dense || !other.m_is_dense) {
+        insert_pairs(source, other.get_sorted_successors(other_source));
+        return;
+    }
+    std::size_t num_blocks = get_num_blocks_per_row();
+    std::size_t first_block = source * num_blocks;
+    m_size -= m_data.count(first_block, num_blocks);
+    m_data.or_assign(first_block, other.get_row(other_source), num_blocks);
+    m_size += m_data.count(first_block, num_blocks);
+    invalidate_caches();
+}
+
+void RoleDenotation::insert_composition(const RoleDenotation& left, const RoleDenotation& right) {
+    assert(left.m_num_objects == m_num_objects && right.m_num_objects == m_num_objects);
+    // Upper bound on the number of pairs of the product.
+    std::vector<int> num_successors(m_num_objects, 0);
+    for (const auto pair : right) {
+        ++num_successors[pair.first];
+    }
+    std::size_t max_size = m_size;
+    for (const auto pair : left) {
+        max_size += num_successors[pair.second];
+    }
+    if (!m_is_dense && max_size <= static_cast<std::size_t>(get_max_sparse_size())) {
+        PairsOfObjectIndices pairs;
+        pairs.reserve(max_size);
+        pairs.insert(pairs.end(), m_pairs.begin(), m_pairs.end());
+        for (const auto left_pair : left) {
+            if (num_successors[left_pair.second] == 0) {
+                continue;
+            }
+            if (right.m_is_dense) {
+                for (ObjectIndex target : right.get_sorted_successors(left_pair.second)) {
+                    pairs.emplace_back(left_pair.first, target);
+                }
+            } else {
+                for (auto it = right.get_row_begin(left_pair.second); it != right.m_pairs.end() && it->first == left_pair.second; ++it) {
+                    pairs.emplace_back(left_pair.first, it->second);
+                }
+            }
+        }
+        std::sort(pairs.begin(), pairs.end());
+        pairs.erase(std::unique(pairs.begin(), pairs.end()), pairs.end());
+        m_pairs = std::move(pairs);
+        m_size = m_pairs.size();
+        invalidate_caches();
+        return;
+    }
+    if (!m_is_dense) {
+        convert_to_dense();
+    }
+    std::size_t num_blocks = get_num_blocks_per_row();
+    for (const auto left_pair : left) {
+        if (num_successors[left_pair.second] == 0) {
+            continue;
+        }
+        if (right.m_is_dense) {
+            m_data.or_assign(left_pair.first * num_blocks, right.get_row(left_pair.second), num_blocks);
+        } else {
+            for (auto it = right.get_row_begin(left_pair.second); it != right.m_pairs.end() && it->first == left_pair.second; ++it) {
+                m_data.set(compute_position(left_pair.first, it->second));
+            }
+        }
+    }
+    m_size = m_data.count();
+    update_representation();
+    invalidate_caches();
+}
+
+void RoleDenotation::restrict_successors(ObjectIndex source, const ConceptDenotation& targets) {
+    if (!m_is_dense) {
+        auto row_begin = m_pairs.begin() + std::distance(m_pairs.cbegin(), get_row_begin(source));
+        auto row_end = m_pairs.begin() + std::distance(m_pairs.cbegin(), get_row_end(source));
+        m_pairs.erase(std::remove_if(row_begin, row_end,
+            [&](const PairOfObjectIndices& pair) { return !targets.contains(pair.second); }), row_end);
+        m_size = m_pairs.size();
+        invalidate_caches();
+        return;
+    }
+    std::size_t num_blocks = get_num_blocks_per_row();
+    std::size_t first_block = source * num_blocks;
+    m_size -= m_data.count(first_block, num_blocks);
+    m_data.and_assign(first_block, targets.m_data.data(), num_blocks);
+    m_size += m_data.count(first_block, num_blocks);
+    update_representation();
+    invalidate_caches();
+}
+
+/*
+  Tarjan's algorithm finds the strongly connected components in reverse
+  topological order of the condensation. Hence, when a component is found,
+  the rows of all components reachable from it are complete and the row of
+  the component is the union of its successors and their rows. This needs
+  one row operation per pair, whereas Warshall's algorithm needs one per
+  pair of the closure and was slower on all graphs that we tested.
+*/
+void RoleDenotation::transitive_closure() {
+    // Successors in compressed sparse row format.
+    std::vector<int> offsets(m_num_objects + 1, 0);
+    std::vector<ObjectIndex> successors;
+    successors.reserve(m_size);
+    for (const auto pair : *this) {
+        ++offsets[pair.first + 1];
+        successors.push_back(pair.second);
+    }
+    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+    std::size_t num_blocks = get_num_blocks_per_row();
+    Bitset data(static_cast<std::size_t>(m_num_objects) * m_row_size);
+    std::vector<int> index(m_num_objects, -1);
+    std::vector<int> lowlink(m_num_objects, 0);
+    std::vector<int> component(m_num_objects, -1);
+    std::vector<ObjectIndex> stack;
+    std::vector<ObjectIndex> members;
+    // Explicit call stack of objects and the position of their next successor.
+    std::vector<std::pair<ObjectIndex, int>> call_stack;
+    int num_visited = 0;
+    int num_components = 0;
+    for (ObjectIndex root = 0; root < m_num_objects; ++root) {
+        if (index[root] != -1) {
+            continue;
+        }
+        index[root] = lowlink[root] = num_visited++;
+        stack.push_back(root);
+        call_stack.emplace_back(root, offsets[root]);
+        while (!call_stack.empty()) {
+            ObjectIndex source = call_stack.back().first;
+            int pos = call_stack.back().second;
+            if (pos < offsets[source + 1]) {
+                ++call_stack.back().second;
+                ObjectIndex target = successors[pos];
+                if (index[target] == -1) {
+                    index[target] = lowlink[target] = num_visited++;
+                    stack.push_back(target);
+                    call_stack.emplace_back(target, offsets[target]);
+                } else if (component[target] == -1) {
+                    lowlink[source] = std::min(lowlink[source], index[target]);
+                }
+                continue;
+            }
+            call_stack.pop_back();
+            if (!call_stack.empty()) {
+                ObjectIndex parent = call_stack.back().first;
+                lowlink[parent] = std::min(lowlink[parent], lowlink[source]);
+            }
+            if (lowlink[source] != index[source]) {
+                continue;
+            }
+            members.clear();
+            ObjectIndex top;
+            do {
+                top = stack.back();
+                stack.pop_back();
+                component[top] = num_components;
+                members.push_back(top);
+            } while (top != source);
+            std::size_t first_block = source * num_blocks;
+            bool is_cyclic = false;
+            for (ObjectIndex member : members) {
+                for (int i = offsets[member]; i < offsets[member + 1]; ++i) {
+                    ObjectIndex target = successors[i];
+                    if (component[target] == num_components) {
+                        is_cyclic = true;
+                    } else {
+                        data.set(compute_position(source, target));
+                        data.or_assign(first_block, data.data() + target * num_blocks, num_blocks);
+                    }
+                }
+            }
+            if (is_cyclic) {
+                for (ObjectIndex member : members) {
+                    data.set(compute_position(source, member));
+                }
+            }
+            for (ObjectIndex member : members) {
+                if (member != source) {
+                    std::copy(data.data() + first_block, data.data() + first_block + num_blocks, data.data() + member * num_blocks);
+                }
+            }
+            ++num_components;
+        }
+    }
+    m_data = std::move(data);
+    PairsOfObjectIndices().swap(m_pairs);
+    m_is_dense = true;
+    m_size = m_data.count();
+    update_representation();
+    invalidate_caches();
+}
+
+bool RoleDenotation::is_dense() const {
+    return m_is_dense;
+}
+
+std::size_t RoleDenotation::compute_memory_usage() const {
+    if (m_is_dense) {
+        return m_data.num_blocks() * sizeof(Block);
+    }
+    return m_pairs.capacity() * sizeof(PairOfObjectIndices);
+}
+
 }
@@ -0,0 +1,178 @@
+#include "../../include/dlplan/core.h"
+
+#include <algorithm>
+#include <cassert>
+
+
+namespace dlplan::core {
+
+using Block = std::uint64_t;
+using Bitset = utils::DynamicBitset<Block>;
+
+static int compute_num_blocks(int num_objects) {
+    return (num_objects + Bitset::bits_per_block - 1) / Bitset::bits_per_block;
+}
+
+static std::vector<int> compute_num_objects(const RoleDenotations& denotations) {
+    std::vector<int> result;
+    result.reserve(denotations.size());
+    for (const auto* denotation : denotations) {
+        result.push_back(denotation->get_num_objects());
+    }
+    return result;
+}
+
+RoleDenotationMatrix::RoleDenotationMatrix(const std::vector<int>& num_objects)
+    : m_num_objects(num_objects),
+      m_max_num_objects(num_objects.empty() ? 0 : *std::max_element(num_objects.begin(), num_objects.end())),
+      m_num_blocks_per_object(compute_num_blocks(m_max_num_objects)),
+      m_data(Bitset(num_objects.size() * get_num_blocks_per_row() * Bitset::bits_per_block)) { }
+
+RoleDenotationMatrix::RoleDenotationMatrix(const RoleDenotations& denotations)
+    : RoleDenotationMatrix(compute_num_objects(denotations)) {
+    Block* data = m_data.data();
+    for (std::size_t row = 0; row < denotations.size(); ++row) {
+        const RoleDenotation& denotation = *denotations[row];
+        if (denotation.m_is_dense) {
+            std::size_t num_blocks = denotation.get_num_blocks_per_row();
+            Block* row_data = data + row * get_num_blocks_per_row();
+            for (int source = 0; source < denotation.m_num_objects; ++source) {
+                const Block* successors = denotation.get_row(source);
+                std::copy(successors, successors + num_blocks, row_data + source * m_num_blocks_per_object);
+            }
+        } else {
+            for (const auto& pair : denotation.m_pairs) {
+                m_data.set(compute_position(row, pair));
+            }
+        }
+    }
+}
+
+RoleDenotationMatrix::RoleDenotationMatrix(const RoleDenotationMatrix& other) = default;
+
+RoleDenotationMatrix& RoleDenotationMatrix::operator=(const RoleDenotationMatrix& other) = default;
+
+RoleDenotationMatrix::RoleDenotationMatrix(RoleDenotationMatrix&& other) = default;
+
+RoleDenotationMatrix& RoleDenotationMatrix::operator=(RoleDenotationMatrix&& other) = default;
+
+RoleDenotationMatrix::~RoleDenotationMatrix() = default;
+
+std::size_t RoleDenotationMatrix::get_num_blocks_per_row() const {
+    return static_cast<std::size_t>(m_max_num_objects) * m_num_blocks_per_object;
+}
+
+std::size_t RoleDenotationMatrix::compute_position(int row, const PairOfObjectIndices& value) const {
+    assert(row >= 0 && row < get_num_rows());
+    assert(value.first >= 0 && value.first < m_num_objects[row]);
+    assert(value.second >= 0 && value.second < m_num_objects[row]);
+    return (row * get_num_blocks_per_row() + value.first * m_num_blocks_per_object) * Bitset::bits_per_block + value.second;
+}
+
+/*
+  Only the first n successor rows of a row with n objects are used and
+  only the first n bits of each of them.
+*/
+void RoleDenotationMatrix::zero_padding_bits() {
+    Block* data = m_data.data();
+    for (std::size_t row = 0; row < m_num_objects.size(); ++row) {
+        Block* row_data = data + row * get_num_blocks_per_row();
+        int num_objects = m_num_objects[row];
+        int num_blocks = compute_num_blocks(num_objects);
+        int num_bits_in_last_block = num_objects % Bitset::bits_per_block;
+        for (int source = 0; source < num_objects; ++source) {
+            Block* successors = row_data + source * m_num_blocks_per_object;
+            if (num_bits_in_last_block != 0) {
+                successors[num_blocks - 1] &= ~Block(0) >> (Bitset::bits_per_block - num_bits_in_last_block);
+            }
+            std::fill(successors + num_blocks, successors + m_num_blocks_per_object, Block(0));
+        }
+        std::fill(row_data + num_objects * m_num_blocks_per_object, row_data + get_num_blocks_per_row(), Block(0));
+    }
+}
+
+bool RoleDenotationMatrix::operator==(const RoleDenotationMatrix& other) const {
+    if (this != &other) {
+        return m_num_objects == other.m_num_objects && m_data == other.m_data;
+    }
+    return true;
+}
+
+bool RoleDenotationMatrix::operator!=(const RoleDenotationMatrix& other) const {
+    return !(*this == other);
+}
+
+RoleDenotationMatrix& RoleDenotationMatrix::operator&=(const RoleDenotationMatrix& other) {
+    assert(m_num_objects == other.m_num_objects);
+    m_data &= other.m_data;
+    return *this;
+}
+
+RoleDenotationMatrix& RoleDenotationMatrix::operator|=(const RoleDenotationMatrix& other) {
+    assert(m_num_objects == other.m_num_objects);
+    m_data |= other.m_data;
+    return *this;
+}
+
+RoleDenotationMatrix& RoleDenotationMatrix::operator-=(const RoleDenotationMatrix& other) {
+    assert(m_num_objects == other.m_num_objects);
+    m_data -= other.m_data;
+    return *this;
+}
+
+RoleDenotationMatrix& RoleDenotationMatrix::operator~() {
+    ~m_data;
+    zero_padding_bits();
+    return *this;
+}
+
+bool RoleDenotationMatrix::contains(int row, const PairOfObjectIndices& value) const {
+    return m_data.test(compute_position(row, value));
+}
+
+void RoleDenotationMatrix::insert(int row, const PairOfObjectIndices& value) {
+    m_data.set(compute_position(row, value));
+}
+
+void RoleDenotationMatrix::erase(int row, const PairOfObjectIndices& value) {
+    m_data.reset(compute_position(row, value));
+}
+
+int RoleDenotationMatrix::size(int row) const {
+    assert(row >= 0 && row < get_num_rows());
+    return m_data.count(row * get_num_blocks_per_row(), get_num_blocks_per_row());
+}
+
+RoleDenotation RoleDenotationMatrix::get_denotation(int row) const {
+    assert(row >= 0 && row < get_num_rows());
+    RoleDenotation result(m_num_objects[row]);
+    std::size_t num_blocks = result.get_num_blocks_per_row();
+    result.m_data = Bitset(static_cast<std::size_t>(result.m_num_objects) * result.m_row_size);
+    const Block* row_data = m_data.data() + row * get_num_blocks_per_row();
+    for (int source = 0; source < result.m_num_objects; ++source) {
+        const Block* successors = row_data + source * m_num_blocks_per_object;
+        std::copy(successors, successors + num_blocks, result.m_data.data() + source * num_blocks);
+    }
+    result.m_is_dense = true;
+    result.m_size = result.m_data.count();
+    result.update_representation();
+    return result;
+}
+
+std::size_t RoleDenotationMatrix::compute_memory_usage() const {
+    return m_data.num_blocks() * sizeof(Block) + m_num_objects.capacity() * sizeof(int);
+}
+
+std::size_t RoleDenotationMatrix::hash() const {
+    return m_data.hash();
+}
+
+int RoleDenotationMatrix::get_num_rows() const {
+    return m_num_objects.size();
+}
+
+int RoleDenotationMatrix::get_num_objects(int row) const {
+    return m_num_objects[row];
+}
+
+}
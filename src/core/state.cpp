@@ -40,9 +40,20 @@ State::State(std::shared_ptr<const InstanceInfo> instance_info, const AtomIndice
     }
 }
 
-State::State(const State&) = default;
-
-State& State::operator=(const State&) = default;
+// Another thread can publish the index of other while it is copied.
+State::State(const State& other)
+    : m_instance_info(other.m_instance_info), m_atom_indices(other.m_atom_indices), m_index(other.m_index),
+      m_atom_indices_by_predicate(std::atomic_load(&other.m_atom_indices_by_predicate)) { }
+
+State& State::operator=(const State& other) {
+    if (this != &other) {
+        m_instance_info = other.m_instance_info;
+        m_atom_indices = other.m_atom_indices;
+        m_index = other.m_index;
+        m_atom_indices_by_predicate = std::atomic_load(&other.m_atom_indices_by_predicate);
+    }
+    return *this;
+}
 
 State::State(State&& other) = default;
 
@@ -66,6 +77,31 @@ const AtomIndices& State::get_atom_indices() const {
     return m_atom_indices;
 }
 
+/*
+  Threads that build the index of the same state concurrently each build
+  their own, but all of them return the one that was published first.
+*/
+const AtomIndices& State::get_atom_indices(PredicateIndex predicate_index) const {
+    auto atom_indices_by_predicate = std::atomic_load(&m_atom_indices_by_predicate);
+    if (!atom_indices_by_predicate) {
+        const auto& atoms = m_instance_info->get_atoms();
+        std::vector<AtomIndices> built(m_instance_info->get_vocabulary_info()->get_predicates().size());
+        for (int atom_idx : m_atom_indices) {
+            built[atoms[atom_idx].get_predicate_index()].push_back(atom_idx);
+        }
+        std::shared_ptr<const std::vector<AtomIndices>> desired = std::make_shared<const std::vector<AtomIndices>>(std::move(built));
+        // On failure, the index that another thread published is loaded instead.
+        if (std::atomic_compare_exchange_strong(&m_atom_indices_by_predicate, &atom_indices_by_predicate, desired)) {
+            atom_indices_by_predicate = std::move(desired);
+        }
+    }
+    static const AtomIndices empty;
+    if (predicate_index < 0 || predicate_index >= static_cast<int>(atom_indices_by_predicate->size())) {
+        return empty;
+    }
+    return (*atom_indices_by_predicate)[predicate_index];
+}
+
 StateIndex State::get_index() const {
     return m_index;
 }
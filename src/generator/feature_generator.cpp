@@ -91,6 +91,7 @@ FeatureGeneratorImpl::~FeatureGeneratorImpl() = default;
 FeatureRepresentations FeatureGeneratorImpl::generate(
     core::SyntacticElementFactory& factory,
     const core::States& states,
+    core::DenotationsCaches& caches,
     int concept_complexity_limit,
     int role_complexity_limit,
     int boolean_complexity_limit,
@@ -106,8 +107,6 @@ FeatureRepresentations FeatureGeneratorImpl::generate(
     for (auto& r : m_numerical_inductive_rules) r->initialize();
     // Initialize memory to store intermediate results.
     GeneratorData data(factory, std::max({concept_complexity_limit, role_complexity_limit, boolean_complexity_limit, count_numerical_complexity_limit, distance_numerical_complexity_limit}), time_limit, feature_limit);
-    // Initialize cache.
-    core::DenotationsCaches caches;
     generate_base(states, data, caches);
     generate_inductively(states, concept_complexity_limit, role_complexity_limit, boolean_complexity_limit, count_numerical_complexity_limit, distance_numerical_complexity_limit, data, caches);
     return data.m_reprs;
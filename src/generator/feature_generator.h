@@ -135,6 +135,7 @@ public:
     FeatureRepresentations generate(
         core::SyntacticElementFactory& factory,
         const core::States& states,
+        core::DenotationsCaches& caches,
         int concept_complexity_limit,
         int role_complexity_limit,
         int boolean_complexity_limit,
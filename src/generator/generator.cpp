@@ -37,7 +37,22 @@ FeatureRepresentations FeatureGenerator::generate(
     int distance_numerical_complexity_limit,
     int time_limit,
     int feature_limit) {
-    return m_pImpl->generate(factory, states, concept_complexity_limit, role_complexity_limit, boolean_complexity_limit, count_numerical_complexity_limit, distance_numerical_complexity_limit, time_limit, feature_limit);
+    core::DenotationsCaches caches;
+    return m_pImpl->generate(factory, states, caches, concept_complexity_limit, role_complexity_limit, boolean_complexity_limit, count_numerical_complexity_limit, distance_numerical_complexity_limit, time_limit, feature_limit);
+}
+
+FeatureRepresentations FeatureGenerator::generate(
+    core::SyntacticElementFactory& factory,
+    const core::States& states,
+    core::DenotationsCaches& caches,
+    int concept_complexity_limit,
+    int role_complexity_limit,
+    int boolean_complexity_limit,
+    int count_numerical_complexity_limit,
+    int distance_numerical_complexity_limit,
+    int time_limit,
+    int feature_limit) {
+    return m_pImpl->generate(factory, states, caches, concept_complexity_limit, role_complexity_limit, boolean_complexity_limit, count_numerical_complexity_limit, distance_numerical_complexity_limit, time_limit, feature_limit);
 }
 
 void FeatureGenerator::set_generate_empty_boolean(bool enable) {
@@ -231,7 +246,8 @@ FeatureRepresentations generate_features(
     generator.set_generate_top_role(generate_top_role);
     generator.set_generate_transitive_closure_role(generate_transitive_closure_role);
     generator.set_generate_transitive_reflexive_closure_role(generate_transitive_reflexive_closure_role);
-    return generator.generate(factory, states, concept_complexity_limit,
+    core::DenotationsCaches caches;
+    return generator.generate(factory, states, caches, concept_complexity_limit,
         role_complexity_limit,
         boolean_complexity_limit,
         count_numerical_complexity_limit,
@@ -0,0 +1,306 @@
+#include "../../include/dlplan/utils/bitset_kernels.h"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define DLPLAN_X86_KERNELS
+#include <immintrin.h>
+#endif
+
+
+namespace dlplan::utils::bitset_kernels {
+
+namespace scalar {
+static void and_assign(Block* dst, const Block* src, std::size_t num_blocks) {
+    for (std::size_t i = 0; i < num_blocks; ++i) dst[i] &= src[i];
+}
+
+static void or_assign(Block* dst, const Block* src, std::size_t num_blocks) {
+    for (std::size_t i = 0; i < num_blocks; ++i) dst[i] |= src[i];
+}
+
+static void diff_assign(Block* dst, const Block* src, std::size_t num_blocks) {
+    for (std::size_t i = 0; i < num_blocks; ++i) dst[i] &= ~src[i];
+}
+
+static void negate(Block* dst, std::size_t num_blocks) {
+    for (std::size_t i = 0; i < num_blocks; ++i) dst[i] = ~dst[i];
+}
+
+static bool intersects(const Block* left, const Block* right, std::size_t num_blocks) {
+    for (std::size_t i = 0; i < num_blocks; ++i) {
+        if (left[i] & right[i]) return true;
+    }
+    return false;
+}
+
+static bool is_subset_of(const Block* left, const Block* right, std::size_t num_blocks) {
+    for (std::size_t i = 0; i < num_blocks; ++i) {
+        if (left[i] & ~right[i]) return false;
+    }
+    return true;
+}
+
+static int count(const Block* data, std::size_t num_blocks) {
+    int result = 0;
+    for (std::size_t i = 0; i < num_blocks; ++i) {
+#if defined(__GNUC__) || defined(__clang__)
+        result += __builtin_popcountll(data[i]);
+#else
+        Block block = data[i];
+        while (block) {
+            block &= block - 1;
+            ++result;
+        }
+#endif
+    }
+    return result;
+}
+}
+
+
+#ifdef DLPLAN_X86_KERNELS
+/*
+  SSE2 is part of the x86-64 baseline, so these need no target attribute.
+  Each loop processes 128 bits and handles the remainder with scalar code.
+*/
+namespace sse2 {
+static void and_assign(Block* dst, const Block* src, std::size_t num_blocks) {
+    std::size_t i = 0;
+    for (; i + 2 <= num_blocks; i += 2) {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_and_si128(a, b));
+    }
+    scalar::and_assign(dst + i, src + i, num_blocks - i);
+}
+
+static void or_assign(Block* dst, const Block* src, std::size_t num_blocks) {
+    std::size_t i = 0;
+    for (; i + 2 <= num_blocks; i += 2) {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_or_si128(a, b));
+    }
+    scalar::or_assign(dst + i, src + i, num_blocks - i);
+}
+
+static void diff_assign(Block* dst, const Block* src, std::size_t num_blocks) {
+    std::size_t i = 0;
+    for (; i + 2 <= num_blocks; i += 2) {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        // andnot computes ~b & a
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_andnot_si128(b, a));
+    }
+    scalar::diff_assign(dst + i, src + i, num_blocks - i);
+}
+
+static void negate(Block* dst, std::size_t num_blocks) {
+    const __m128i ones = _mm_set1_epi32(-1);
+    std::size_t i = 0;
+    for (; i + 2 <= num_blocks; i += 2) {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_xor_si128(a, ones));
+    }
+    scalar::negate(dst + i, num_blocks - i);
+}
+
+static bool is_zero(__m128i value) {
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(value, _mm_setzero_si128())) == 0xFFFF;
+}
+
+static bool intersects(const Block* left, const Block* right, std::size_t num_blocks) {
+    std::size_t i = 0;
+    for (; i + 2 <= num_blocks; i += 2) {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(left + i));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(right + i));
+        if (!is_zero(_mm_and_si128(a, b))) return true;
+    }
+    return scalar::intersects(left + i, right + i, num_blocks - i);
+}
+
+static bool is_subset_of(const Block* left, const Block* right, std::size_t num_blocks) {
+    std::size_t i = 0;
+    for (; i + 2 <= num_blocks; i += 2) {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(left + i));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(right + i));
+        if (!is_zero(_mm_andnot_si128(b, a))) return false;
+    }
+    return scalar::is_subset_of(left + i, right + i, num_blocks - i);
+}
+}
+
+
+/*
+  AVX2 kernels process 256 bits per iteration. They are compiled with a
+  target attribute such that the rest of the library does not require AVX2.
+*/
+namespace avx2 {
+__attribute__((target("avx2")))
+static void and_assign(Block* dst, const Block* src, std::size_t num_blocks) {
+    std::size_t i = 0;
+    for (; i + 4 <= num_blocks; i += 4) {
+        __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dst + i));
+        __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_and_si256(a, b));
+    }
+    scalar::and_assign(dst + i, src + i, num_blocks - i);
+}
+
+__attribute__((target("avx2")))
+static void or_assign(Block* dst, const Block* src, std::size_t num_blocks) {
+    std::size_t i = 0;
+    for (; i + 4 <= num_blocks; i += 4) {
+        __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dst + i));
+        __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_or_si256(a, b));
+    }
+    scalar::or_assign(dst + i, src + i, num_blocks - i);
+}
+
+__attribute__((target("avx2")))
+static void diff_assign(Block* dst, const Block* src, std::size_t num_blocks) {
+    std::size_t i = 0;
+    for (; i + 4 <= num_blocks; i += 4) {
+        __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dst + i));
+        __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_andnot_si256(b, a));
+    }
+    scalar::diff_assign(dst + i, src + i, num_blocks - i);
+}
+
+__attribute__((target("avx2")))
+static void negate(Block* dst, std::size_t num_blocks) {
+    const __m256i ones = _mm256_set1_epi32(-1);
+    std::size_t i = 0;
+    for (; i + 4 <= num_blocks; i += 4) {
+        __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dst + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_xor_si256(a, ones));
+    }
+    scalar::negate(dst + i, num_blocks - i);
+}
+
+__attribute__((target("avx2")))
+static bool intersects(const Block* left, const Block* right, std::size_t num_blocks) {
+    std::size_t i = 0;
+    for (; i + 4 <= num_blocks; i += 4) {
+        __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(left + i));
+        __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(right + i));
+        // testz returns 1 iff a & b == 0
+        if (!_mm256_testz_si256(a, b)) return true;
+    }
+    return scalar::intersects(left + i, right + i, num_blocks - i);
+}
+
+__attribute__((target("avx2")))
+static bool is_subset_of(const Block* left, const Block* right, std::size_t num_blocks) {
+    std::size_t i = 0;
+    for (; i + 4 <= num_blocks; i += 4) {
+        __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(left + i));
+        __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(right + i));
+        // testc returns 1 iff ~b & a == 0
+        if (!_mm256_testc_si256(b, a)) return false;
+    }
+    return scalar::is_subset_of(left + i, right + i, num_blocks - i);
+}
+}
+
+
+namespace popcnt {
+__attribute__((target("popcnt")))
+static int count(const Block* data, std::size_t num_blocks) {
+    int result = 0;
+    for (std::size_t i = 0; i < num_blocks; ++i) {
+        result += __builtin_popcountll(data[i]);
+    }
+    return result;
+}
+}
+#endif
+
+
+struct Kernels {
+    void (*and_assign)(Block*, const Block*, std::size_t);
+    void (*or_assign)(Block*, const Block*, std::size_t);
+    void (*diff_assign)(Block*, const Block*, std::size_t);
+    void (*negate)(Block*, std::size_t);
+    bool (*intersects)(const Block*, const Block*, std::size_t);
+    bool (*is_subset_of)(const Block*, const Block*, std::size_t);
+    int (*count)(const Block*, std::size_t);
+    const char* instruction_set;
+};
+
+static Kernels select_kernels() {
+    Kernels kernels{
+        scalar::and_assign,
+        scalar::or_assign,
+        scalar::diff_assign,
+        scalar::negate,
+        scalar::intersects,
+        scalar::is_subset_of,
+        scalar::count,
+        "scalar"};
+#ifdef DLPLAN_X86_KERNELS
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("popcnt")) {
+        kernels.count = popcnt::count;
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        kernels.and_assign = avx2::and_assign;
+        kernels.or_assign = avx2::or_assign;
+        kernels.diff_assign = avx2::diff_assign;
+        kernels.negate = avx2::negate;
+        kernels.intersects = avx2::intersects;
+        kernels.is_subset_of = avx2::is_subset_of;
+        kernels.instruction_set = "avx2";
+    } else if (__builtin_cpu_supports("sse2")) {
+        kernels.and_assign = sse2::and_assign;
+        kernels.or_assign = sse2::or_assign;
+        kernels.diff_assign = sse2::diff_assign;
+        kernels.negate = sse2::negate;
+        kernels.intersects = sse2::intersects;
+        kernels.is_subset_of = sse2::is_subset_of;
+        kernels.instruction_set = "sse2";
+    }
+#endif
+    return kernels;
+}
+
+static const Kernels& get_kernels() {
+    static const Kernels kernels = select_kernels();
+    return kernels;
+}
+
+
+void and_assign(Block* dst, const Block* src, std::size_t num_blocks) {
+    get_kernels().and_assign(dst, src, num_blocks);
+}
+
+void or_assign(Block* dst, const Block* src, std::size_t num_blocks) {
+    get_kernels().or_assign(dst, src, num_blocks);
+}
+
+void diff_assign(Block* dst, const Block* src, std::size_t num_blocks) {
+    get_kernels().diff_assign(dst, src, num_blocks);
+}
+
+void negate(Block* dst, std::size_t num_blocks) {
+    get_kernels().negate(dst, num_blocks);
+}
+
+bool intersects(const Block* left, const Block* right, std::size_t num_blocks) {
+    return get_kernels().intersects(left, right, num_blocks);
+}
+
+bool is_subset_of(const Block* left, const Block* right, std::size_t num_blocks) {
+    return get_kernels().is_subset_of(left, right, num_blocks);
+}
+
+int count(const Block* data, std::size_t num_blocks) {
+    return get_kernels().count(data, num_blocks);
+}
+
+const char* get_instruction_set() {
+    return get_kernels().instruction_set;
+}
+
+}
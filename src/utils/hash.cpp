@@ -1,20 +1,19 @@
 #include "../../include/dlplan/utils/hash.h"
 
+#include "MurmurHash3.h"
+
 
 namespace dlplan::utils {
+std::size_t hash_bytes(const void* data, std::size_t num_bytes, std::uint32_t seed) {
+    std::uint64_t out[2];
+    MurmurHash3_x64_128(data, static_cast<int>(num_bytes), seed, out);
+    return static_cast<std::size_t>(out[0]);
+}
 size_t hash_impl<std::vector<unsigned>>::operator()(const std::vector<unsigned>& data) const {
-    size_t seed = data.size();
-    for (unsigned value : data) {
-        dlplan::utils::hash_combine(seed, value);
-    }
-    return seed;
+    return hash_bytes(data.data(), data.size() * sizeof(unsigned), data.size());
 }
 size_t hash_impl<std::vector<int>>::operator()(const std::vector<int>& data) const {
-    size_t seed = data.size();
-    for (int value : data) {
-        dlplan::utils::hash_combine(seed, value);
-    }
-    return seed;
+    return hash_bytes(data.data(), data.size() * sizeof(int), data.size());
 }
 
 
@@ -0,0 +1,68 @@
+#include "memory_mapped_file.h"
+
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define DLPLAN_HAS_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+
+namespace dlplan::utils {
+
+MemoryMappedFile::MemoryMappedFile(const std::string& filename)
+    : m_data(nullptr), m_size(0) {
+#ifdef DLPLAN_HAS_MMAP
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("MemoryMappedFile::MemoryMappedFile - cannot open " + filename + ".");
+    }
+    struct stat status;
+    if (::fstat(fd, &status) != 0) {
+        ::close(fd);
+        throw std::runtime_error("MemoryMappedFile::MemoryMappedFile - cannot read size of " + filename + ".");
+    }
+    m_size = static_cast<std::size_t>(status.st_size);
+    if (m_size > 0) {
+        void* data = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED) {
+            ::close(fd);
+            throw std::runtime_error("MemoryMappedFile::MemoryMappedFile - cannot map " + filename + ".");
+        }
+        m_data = static_cast<const char*>(data);
+    }
+    // The mapping remains valid after closing the file descriptor.
+    ::close(fd);
+#else
+    std::ifstream file(filename, std::ios::binary);
+    if (!file) {
+        throw std::runtime_error("MemoryMappedFile::MemoryMappedFile - cannot open " + filename + ".");
+    }
+    m_buffer.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    m_data = m_buffer.data();
+    m_size = m_buffer.size();
+#endif
+}
+
+MemoryMappedFile::~MemoryMappedFile() {
+#ifdef DLPLAN_HAS_MMAP
+    if (m_data) {
+        ::munmap(const_cast<char*>(m_data), m_size);
+    }
+#endif
+}
+
+const char* MemoryMappedFile::data() const {
+    return m_data;
+}
+
+std::size_t MemoryMappedFile::size() const {
+    return m_size;
+}
+
+}
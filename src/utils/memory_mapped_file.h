@@ -0,0 +1,35 @@
+#ifndef DLPLAN_SRC_UTILS_MEMORY_MAPPED_FILE_H_
+#define DLPLAN_SRC_UTILS_MEMORY_MAPPED_FILE_H_
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+
+namespace dlplan::utils {
+
+/**
+ * Read-only view of a file. On POSIX systems, the file is mapped into
+ * memory such that opening it is cheap and pages are read on first access.
+ * Elsewhere, the file is read into a buffer.
+ */
+class MemoryMappedFile {
+private:
+    const char* m_data;
+    std::size_t m_size;
+    std::vector<char> m_buffer;
+
+public:
+    /// @brief Maps the file and throws std::runtime_error if it cannot be opened.
+    explicit MemoryMappedFile(const std::string& filename);
+    MemoryMappedFile(const MemoryMappedFile& other) = delete;
+    MemoryMappedFile& operator=(const MemoryMappedFile& other) = delete;
+    ~MemoryMappedFile();
+
+    const char* data() const;
+    std::size_t size() const;
+};
+
+}
+
+#endif
@@ -3,6 +3,7 @@
 #include "../../include/dlplan/core.h"
 
 using namespace dlplan::core;
+using namespace std::string_literals;
 
 
 namespace dlplan::core::tests {
@@ -34,4 +35,60 @@ TEST(DLPTests, BooleanEmpty) {
     EXPECT_EQ(boolean_4->evaluate(state_0), true);
 }
 
+TEST(DLPTests, BooleanEmptyShortCircuit) {
+    auto vocabulary = std::make_shared<VocabularyInfo>();
+    auto predicate_0 = vocabulary->add_predicate("concept_0", 1);
+    auto predicate_1 = vocabulary->add_predicate("concept_1", 1);
+    auto predicate_2 = vocabulary->add_predicate("role_0", 2);
+    auto instance = std::make_shared<InstanceInfo>(vocabulary, 0);
+    auto atom_0 = instance->add_atom("concept_0", {"A"});
+    auto atom_1 = instance->add_atom("concept_0", {"B"});
+    auto atom_2 = instance->add_atom("concept_1", {"B"});
+    auto atom_3 = instance->add_atom("role_0", {"A", "B"});
+    auto atom_4 = instance->add_atom("role_0", {"B", "C"});
+    auto atom_5 = instance->add_atom("role_0", {"C", "A"});
+
+    State state_0(instance, {atom_0, atom_1, atom_2, atom_3, atom_4, atom_5}, 0);
+    State state_1(instance, {atom_0, atom_4}, 1);
+
+    SyntacticElementFactory factory(vocabulary);
+
+    // Visiting stops at the first object.
+    int num_visited = 0;
+    auto concept_0 = factory.parse_concept("c_some(r_primitive(role_0,0,1),c_primitive(concept_0,0))");
+    EXPECT_FALSE(concept_0->for_each(state_0, [&](ObjectIndex) { ++num_visited; return false; }));
+    EXPECT_EQ(num_visited, 1);
+
+    // Lazy evaluation agrees with the denotation.
+    for (const auto& description : {
+        "c_some(r_primitive(role_0,0,1),c_primitive(concept_1,0))",
+        "c_and(c_primitive(concept_0,0),c_primitive(concept_1,0))",
+        "c_diff(c_primitive(concept_0,0),c_primitive(concept_1,0))",
+        "c_or(c_primitive(concept_1,0),c_primitive(concept_0,0))"}) {
+        auto concept_ = factory.parse_concept(description);
+        auto boolean = factory.parse_boolean("b_empty("s + description + ")");
+        for (const auto& state : {state_0, state_1}) {
+            EXPECT_EQ(boolean->evaluate(state), concept_->evaluate(state).empty());
+            ConceptDenotation visited(state.get_instance_info()->get_objects().size());
+            concept_->for_each(state, [&](ObjectIndex object) { visited.insert(object); return true; });
+            EXPECT_EQ(visited, concept_->evaluate(state));
+        }
+    }
+    for (const auto& description : {
+        "r_inverse(r_primitive(role_0,0,1))",
+        "r_restrict(r_primitive(role_0,0,1),c_primitive(concept_1,0))",
+        "r_and(r_primitive(role_0,0,1),r_identity(c_primitive(concept_0,0)))",
+        "r_diff(r_primitive(role_0,0,1),r_inverse(r_primitive(role_0,0,1)))",
+        "r_or(r_identity(c_primitive(concept_1,0)),r_primitive(role_0,0,1))"}) {
+        auto role = factory.parse_role(description);
+        auto boolean = factory.parse_boolean("b_empty("s + description + ")");
+        for (const auto& state : {state_0, state_1}) {
+            EXPECT_EQ(boolean->evaluate(state), role->evaluate(state).empty());
+            RoleDenotation visited(state.get_instance_info()->get_objects().size());
+            role->for_each(state, [&](const PairOfObjectIndices& pair) { visited.insert(pair); return true; });
+            EXPECT_EQ(visited, role->evaluate(state));
+        }
+    }
+}
+
 }
@@ -25,6 +25,10 @@ TEST(DLPTests, ConceptInclusion) {
     auto boolean_0 = factory.parse_boolean("b_inclusion(c_primitive(concept_1,0),c_primitive(concept_2,0))");
     EXPECT_EQ(boolean_0->evaluate(state_0), true);
     EXPECT_EQ(boolean_0->evaluate(state_1), false);
+
+    auto boolean_1 = factory.parse_boolean("b_inclusion(c_primitive(concept_2,0),c_primitive(concept_1,0))");
+    EXPECT_EQ(boolean_1->evaluate(state_0), false);
+    EXPECT_EQ(boolean_1->evaluate(state_1), false);
 }
 
 }
@@ -2,8 +2,16 @@
 
 #include "../utils/denotation.h"
 
+#include "../../src/core/denotations_file.h"
+
 #include "../../include/dlplan/core.h"
 
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
 using namespace dlplan::core;
 
 namespace dlplan::tests::core
@@ -67,4 +75,613 @@ namespace dlplan::tests::core
         );
         EXPECT_EQ(boolean_0->evaluate(States{state_0, state_1}, caches), boolean_0->evaluate(States{state_0, state_1}, caches));
     }
+
+    TEST(DLPTests, CachingUniqueStorage)
+    {
+        DenotationsCaches caches;
+        auto& cache = caches.get_concept_denotation_cache();
+        std::vector<const ConceptDenotation*> denotations;
+        for (int i = 0; i < 1000; ++i) {
+            ConceptDenotation denotation(10);
+            denotation.insert(i % 10);
+            denotations.push_back(cache.insert_denotation(std::move(denotation)));
+        }
+        // Equal denotations are stored once and pointers remain stable.
+        EXPECT_EQ(cache.m_shards[0].m_current.m_storage.size(), 10);
+        for (int i = 0; i < 1000; ++i) {
+            EXPECT_EQ(denotations[i], denotations[i % 10]);
+            EXPECT_TRUE(denotations[i]->contains(i % 10));
+            EXPECT_EQ(denotations[i]->size(), 1);
+        }
+    }
+
+    TEST(DLPTests, CachingDistances)
+    {
+        auto vocabulary = std::make_shared<VocabularyInfo>();
+        auto predicate_0 = vocabulary->add_predicate("conn", 2);
+        auto predicate_1 = vocabulary->add_predicate("at", 1);
+        auto predicate_2 = vocabulary->add_predicate("goal", 1);
+        auto predicate_3 = vocabulary->add_predicate("start", 2);
+        auto predicate_4 = vocabulary->add_predicate("end", 2);
+        auto instance = std::make_shared<InstanceInfo>(vocabulary, 0);
+        auto atom_0 = instance->add_atom("conn", {"A", "B"});
+        auto atom_1 = instance->add_atom("conn", {"B", "C"});
+        auto atom_2 = instance->add_atom("conn", {"C", "D"});
+        auto atom_3 = instance->add_atom("conn", {"D", "B"});
+        auto atom_4 = instance->add_atom("at", {"A"});
+        auto atom_5 = instance->add_atom("at", {"C"});
+        auto atom_6 = instance->add_atom("goal", {"D"});
+        auto atom_7 = instance->add_atom("goal", {"B"});
+        auto atom_8 = instance->add_atom("start", {"X", "A"});
+        auto atom_9 = instance->add_atom("end", {"X", "D"});
+        auto atom_10 = instance->add_atom("start", {"Y", "D"});
+        auto atom_11 = instance->add_atom("end", {"Y", "C"});
+        auto atom_12 = instance->add_atom("end", {"Y", "A"});
+
+        States states{
+            State(instance, {atom_0, atom_1, atom_2, atom_3, atom_4, atom_6, atom_8, atom_9}, 0),
+            State(instance, {atom_0, atom_1, atom_2, atom_3, atom_5, atom_6, atom_7, atom_8, atom_10, atom_11}, 1),
+            State(instance, {atom_0, atom_1, atom_2, atom_3, atom_4, atom_5, atom_7, atom_8, atom_9, atom_10, atom_12}, 2)};
+
+        SyntacticElementFactory factory(vocabulary);
+        std::vector<std::shared_ptr<const Numerical>> numericals{
+            factory.parse_numerical("n_concept_distance(c_primitive(at,0),r_primitive(conn,0,1),c_primitive(goal,0))"),
+            factory.parse_numerical("n_sum_concept_distance(c_primitive(at,0),r_primitive(conn,0,1),c_primitive(goal,0))"),
+            factory.parse_numerical("n_role_distance(r_primitive(start,0,1),r_primitive(conn,0,1),r_primitive(end,0,1))"),
+            factory.parse_numerical("n_sum_role_distance(r_primitive(start,0,1),r_primitive(conn,0,1),r_primitive(end,0,1))")};
+
+        // All numericals share the matrix of the role denotation
+        // after it was requested twice.
+        DenotationsCaches caches;
+        for (const auto& numerical : numericals) {
+            for (const auto& state : states) {
+                EXPECT_EQ(numerical->evaluate(state, caches), numerical->evaluate(state));
+            }
+        }
+        EXPECT_EQ(caches.get_distances_cache().m_distances.size(), 1);
+        EXPECT_EQ(caches.get_distances_cache().m_memory_usage, 6 * 6 * sizeof(std::int16_t));
+        for (const auto& numerical : numericals) {
+            NumericalDenotations denotations;
+            for (const auto& state : states) {
+                denotations.push_back(numerical->evaluate(state));
+            }
+            EXPECT_EQ(*numerical->evaluate(states, caches), denotations);
+        }
+
+        // Matrices are not stored beyond the memory limit.
+        DenotationsCaches limited_caches;
+        limited_caches.set_distances_memory_limit(0);
+        EXPECT_EQ(limited_caches.get_distances_memory_limit(), 0);
+        for (const auto& numerical : numericals) {
+            for (const auto& state : states) {
+                EXPECT_EQ(numerical->evaluate(state, limited_caches), numerical->evaluate(state));
+            }
+        }
+        EXPECT_TRUE(limited_caches.get_distances_cache().m_distances.empty());
+    }
+
+    TEST(DLPTests, CachingStaticElements)
+    {
+        auto vocabulary = std::make_shared<VocabularyInfo>();
+        auto predicate_0 = vocabulary->add_predicate("conn", 2, true);
+        auto predicate_1 = vocabulary->add_predicate("at", 1);
+        auto instance_0 = std::make_shared<InstanceInfo>(vocabulary, 0);
+        auto atom_0_0 = instance_0->add_static_atom("conn", {"A", "B"});
+        auto atom_0_1 = instance_0->add_atom("at", {"A"});
+        auto atom_0_2 = instance_0->add_atom("at", {"B"});
+        auto instance_1 = std::make_shared<InstanceInfo>(vocabulary, 1);
+        auto atom_1_0 = instance_1->add_atom("at", {"A"});
+        auto atom_1_1 = instance_1->add_static_atom("conn", {"B", "A"});
+
+        States states{
+            State(instance_0, {atom_0_1}, 0),
+            State(instance_0, {atom_0_2}, 1),
+            State(instance_1, {atom_1_0}, 0),
+            State(instance_0, {atom_0_1, atom_0_2}, 2)};
+
+        SyntacticElementFactory factory(vocabulary);
+        DenotationsCaches caches;
+
+        // Static elements share one denotation among all states of an instance.
+        auto role = factory.parse_role("r_transitive_closure(r_primitive(conn,0,1))");
+        EXPECT_TRUE(role->is_static());
+        auto role_denotations = role->evaluate(states, caches);
+        EXPECT_EQ((*role_denotations)[0], (*role_denotations)[1]);
+        EXPECT_EQ((*role_denotations)[0], (*role_denotations)[3]);
+        EXPECT_NE((*role_denotations)[0], (*role_denotations)[2]);
+        for (std::size_t i = 0; i < states.size(); ++i) {
+            EXPECT_EQ(*(*role_denotations)[i], role->evaluate(states[i]));
+        }
+        auto numerical = factory.parse_numerical("n_count(r_primitive(conn,0,1))");
+        EXPECT_EQ(*numerical->evaluate(states, caches), NumericalDenotations({1, 1, 1, 1}));
+
+        // Dynamic elements over static children.
+        auto concept_0 = factory.parse_concept("c_some(r_primitive(conn,0,1),c_primitive(at,0))");
+        EXPECT_FALSE(concept_0->is_static());
+        auto concept_denotations = concept_0->evaluate(states, caches);
+        for (std::size_t i = 0; i < states.size(); ++i) {
+            EXPECT_EQ(*(*concept_denotations)[i], concept_0->evaluate(states[i]));
+        }
+    }
+
+    TEST(DLPTests, CachingMapping)
+    {
+        DenotationsCaches caches;
+        auto& cache = caches.get_numerical_denotation_cache();
+        std::vector<const int*> denotations;
+        for (int i = 0; i < 11; ++i) {
+            denotations.push_back(cache.insert_denotation(int(i)));
+        }
+        // Compact keys, keys of static and batched denotations,
+        // and keys that are too sparse for the table.
+        std::vector<std::tuple<ElementIndex, InstanceIndex, StateIndex>> keys{
+            {0, 0, 0}, {0, 0, 1}, {3, 1, 0}, {0, 0, -1}, {2, -1, -1},
+            {0, 0, 150}, {0, 0, 1000000}, {1000000, 0, 0}, {0, 1000000, 0}, {5, -7, 3}};
+        for (std::size_t i = 0; i < keys.size(); ++i) {
+            auto [element, instance, state] = keys[i];
+            EXPECT_EQ(cache.get_denotation(element, instance, state), nullptr);
+            cache.insert_denotation(element, instance, state, denotations[i]);
+        }
+        // Keys that were sparse upon insertion can be inside of the table later.
+        for (int state = 2; state < 200; ++state) {
+            cache.insert_denotation(0, 0, state, denotations[10]);
+        }
+        cache.insert_denotation(0, 0, 250, denotations[10]);
+        for (std::size_t i = 0; i < keys.size(); ++i) {
+            auto [element, instance, state] = keys[i];
+            EXPECT_EQ(cache.get_denotation(element, instance, state), denotations[i]);
+        }
+        EXPECT_EQ(cache.get_denotation(0, 0, 250), denotations[10]);
+        EXPECT_EQ(cache.get_denotation(0, 0, 200), nullptr);
+        EXPECT_EQ(cache.get_denotation(1, 0, 0), nullptr);
+        EXPECT_EQ(cache.get_denotation(0, 2, 0), nullptr);
+
+        // The memory usage includes the table, which has a row per instance.
+        DenotationsCaches other_caches;
+        auto& other_cache = other_caches.get_numerical_denotation_cache();
+        const int* denotation = other_cache.insert_denotation(0);
+        std::size_t num_bytes = other_cache.compute_memory_usage();
+        for (int instance = 0; instance < 60; ++instance) {
+            other_cache.insert_denotation(0, instance, 0, denotation);
+        }
+        EXPECT_GE(other_cache.compute_memory_usage() - num_bytes,
+            60 * (sizeof(std::vector<std::vector<const int*>>) + sizeof(std::vector<const int*>) + 2 * sizeof(const int*)));
+    }
+
+    TEST(DLPTests, CachingMemoryLimit)
+    {
+        auto vocabulary = std::make_shared<VocabularyInfo>();
+        auto predicate_0 = vocabulary->add_predicate("at", 1);
+        auto predicate_1 = vocabulary->add_predicate("conn", 2);
+        auto instance = std::make_shared<InstanceInfo>(vocabulary, 0);
+        States states;
+        for (int i = 0; i < 100; ++i) {
+            auto atom_0 = instance->add_atom("at", {"o" + std::to_string(i)});
+            auto atom_1 = instance->add_atom("conn", {"o" + std::to_string(i), "o" + std::to_string(i + 1)});
+            states.emplace_back(instance, std::vector<Atom>{atom_0, atom_1}, i);
+        }
+        SyntacticElementFactory factory(vocabulary);
+        auto numerical = factory.parse_numerical("n_count(c_some(r_primitive(conn,0,1),c_top))");
+        auto boolean = factory.parse_boolean("b_empty(c_and(c_primitive(at,0),c_some(r_primitive(conn,1,0),c_top)))");
+
+        DenotationsCaches unbounded_caches;
+        for (const auto& state : states) {
+            numerical->evaluate(state, unbounded_caches);
+        }
+        auto statistics = unbounded_caches.get_statistics();
+        EXPECT_EQ(statistics["numerical_denotation"].num_misses, 100);
+        EXPECT_EQ(statistics["numerical_denotation"].num_evictions, 0);
+        EXPECT_GT(statistics["concept_denotation"].num_bytes, 0);
+        EXPECT_GT(unbounded_caches.compute_memory_usage(), 0);
+
+        // Every evaluation evicts and the caches stay bounded.
+        DenotationsCaches caches;
+        caches.set_memory_limit(1);
+        std::size_t max_memory_usage = 0;
+        for (int repetition = 0; repetition < 2; ++repetition) {
+            for (const auto& state : states) {
+                EXPECT_EQ(numerical->evaluate(state, caches), numerical->evaluate(state));
+                EXPECT_EQ(boolean->evaluate(state, caches), boolean->evaluate(state));
+                max_memory_usage = std::max(max_memory_usage, caches.compute_memory_usage());
+            }
+        }
+        EXPECT_LT(max_memory_usage, unbounded_caches.compute_memory_usage());
+        statistics = caches.get_statistics();
+        EXPECT_GT(statistics["concept_denotation"].num_evictions, 0);
+        EXPECT_EQ(statistics["numerical_denotation"].num_misses, 200);
+
+        // Denotations survive an eviction if they are used again.
+        EXPECT_EQ(numerical->evaluate(states[0], caches), 1);
+        EXPECT_EQ(numerical->evaluate(states[0], caches), 1);
+        EXPECT_EQ(numerical->evaluate(states[0], caches), 1);
+        EXPECT_EQ(caches.get_statistics()["numerical_denotation"].num_hits, 2);
+
+        // Collections of denotations are discarded on eviction.
+        EXPECT_EQ(*numerical->evaluate(states, caches), *numerical->evaluate(states, unbounded_caches));
+        EXPECT_EQ(*numerical->evaluate(states, caches), *numerical->evaluate(states, unbounded_caches));
+    }
+
+    TEST(DLPTests, CachingConcurrent)
+    {
+        auto vocabulary = std::make_shared<VocabularyInfo>();
+        auto predicate_0 = vocabulary->add_predicate("at", 1);
+        auto predicate_1 = vocabulary->add_predicate("conn", 2);
+        auto instance = std::make_shared<InstanceInfo>(vocabulary, 0);
+        std::vector<Atom> atoms;
+        for (int i = 0; i < 20; ++i) {
+            atoms.push_back(instance->add_atom("at", {"o" + std::to_string(i)}));
+            atoms.push_back(instance->add_atom("conn", {"o" + std::to_string(i), "o" + std::to_string((i * 7 + 1) % 20)}));
+        }
+        States states;
+        for (int i = 0; i < 200; ++i) {
+            std::vector<Atom> state_atoms;
+            for (int j = 0; j < static_cast<int>(atoms.size()); ++j) {
+                if ((i * 31 + j * 17) % 5 < 2) state_atoms.push_back(atoms[j]);
+            }
+            states.emplace_back(instance, state_atoms, i);
+        }
+        SyntacticElementFactory factory(vocabulary);
+        std::vector<std::shared_ptr<const Numerical>> numericals{
+            factory.parse_numerical("n_count(c_some(r_primitive(conn,0,1),c_primitive(at,0)))"),
+            factory.parse_numerical("n_count(c_all(r_inverse(r_primitive(conn,0,1)),c_primitive(at,0)))"),
+            factory.parse_numerical("n_concept_distance(c_primitive(at,0),r_primitive(conn,0,1),c_not(c_primitive(at,0)))"),
+        };
+        std::vector<int> expected;
+        for (const auto& state : states) {
+            for (const auto& numerical : numericals) {
+                expected.push_back(numerical->evaluate(state));
+            }
+        }
+
+        EXPECT_THROW(DenotationsCaches(3), std::runtime_error);
+        for (std::size_t memory_limit : {std::numeric_limits<std::size_t>::max(), std::size_t(4096)}) {
+            DenotationsCaches caches(8);
+            EXPECT_TRUE(caches.is_concurrent());
+            caches.set_memory_limit(memory_limit);
+            // Threads evaluate overlapping ranges of states, i.e., they
+            // compete for the same denotations, and share the states.
+            const int num_threads = 4;
+            std::vector<std::vector<int>> results(num_threads);
+            std::vector<std::thread> threads;
+            for (int t = 0; t < num_threads; ++t) {
+                threads.emplace_back([&, t]() {
+                    for (int repetition = 0; repetition < 2; ++repetition) {
+                        for (std::size_t i = 0; i < states.size(); ++i) {
+                            const auto& state = states[(i + t * 50) % states.size()];
+                            for (const auto& numerical : numericals) {
+                                results[t].push_back(numerical->evaluate(state, caches));
+                            }
+                        }
+                    }
+                });
+            }
+            for (auto& thread : threads) {
+                thread.join();
+            }
+            for (int t = 0; t < num_threads; ++t) {
+                for (std::size_t i = 0; i < results[t].size(); ++i) {
+                    std::size_t state = (i / numericals.size() + t * 50) % states.size();
+                    EXPECT_EQ(results[t][i], expected[state * numericals.size() + i % numericals.size()]);
+                }
+            }
+            auto statistics = caches.get_statistics();
+            EXPECT_EQ(statistics["numerical_denotation"].num_hits + statistics["numerical_denotation"].num_misses,
+                      num_threads * 2 * states.size() * numericals.size());
+            if (memory_limit == std::numeric_limits<std::size_t>::max()) {
+                EXPECT_EQ(statistics["concept_denotation"].num_evictions, 0);
+                // The second repetition of each thread only hits.
+                EXPECT_GE(statistics["numerical_denotation"].num_hits, num_threads * states.size() * numericals.size());
+            } else {
+                EXPECT_GT(statistics["concept_denotation"].num_evictions, 0);
+            }
+        }
+    }
+
+    TEST(DLPTests, CachingStateScope)
+    {
+        auto vocabulary = std::make_shared<VocabularyInfo>();
+        auto predicate_0 = vocabulary->add_predicate("at", 1);
+        auto predicate_1 = vocabulary->add_predicate("conn", 2);
+        auto predicate_2 = vocabulary->add_predicate("road", 2, true);
+        auto instance = std::make_shared<InstanceInfo>(vocabulary, 0);
+        std::vector<Atom> atoms;
+        for (int i = 0; i < 10; ++i) {
+            instance->add_static_atom("road", {"o" + std::to_string(i), "o" + std::to_string((i + 1) % 10)});
+            atoms.push_back(instance->add_atom("at", {"o" + std::to_string(i)}));
+            atoms.push_back(instance->add_atom("conn", {"o" + std::to_string(i), "o" + std::to_string((i * 3 + 1) % 10)}));
+        }
+        States states;
+        for (int i = 0; i < 100; ++i) {
+            std::vector<Atom> state_atoms;
+            for (int j = 0; j < static_cast<int>(atoms.size()); ++j) {
+                if ((i * 13 + j * 7) % 4 == 0) state_atoms.push_back(atoms[j]);
+            }
+            states.emplace_back(instance, state_atoms, i);
+        }
+        SyntacticElementFactory factory(vocabulary);
+        // Both distances use the matrix of r_primitive(conn,0,1) in each state.
+        std::vector<std::shared_ptr<const Numerical>> numericals{
+            factory.parse_numerical("n_count(c_some(r_primitive(conn,0,1),c_primitive(at,0)))"),
+            factory.parse_numerical("n_count(c_and(c_some(r_primitive(road,0,1),c_top),c_primitive(at,0)))"),
+            factory.parse_numerical("n_concept_distance(c_primitive(at,0),r_primitive(conn,0,1),c_not(c_primitive(at,0)))"),
+            factory.parse_numerical("n_concept_distance(c_not(c_primitive(at,0)),r_primitive(conn,0,1),c_primitive(at,0))"),
+        };
+
+        DenotationsCaches caches;
+        std::size_t memory_usage = 0;
+        for (const auto& state : states) {
+            caches.open_state_scope(state);
+            for (const auto& numerical : numericals) {
+                EXPECT_EQ(numerical->evaluate(state, caches), numerical->evaluate(state));
+                EXPECT_EQ(numerical->evaluate(state, caches), numerical->evaluate(state));
+            }
+            caches.close_state_scope(state);
+            // Only the denotations of static elements outlive the scopes.
+            if (state.get_index() == 0) memory_usage = caches.compute_memory_usage();
+            EXPECT_EQ(caches.compute_memory_usage(), memory_usage);
+        }
+        EXPECT_EQ(caches.get_statistics()["numerical_denotation"].num_hits, 400);
+
+        // Denotations inserted before the scope was opened are kept.
+        numericals[0]->evaluate(states[0], caches);
+        caches.open_state_scope(states[0]);
+        numericals[0]->evaluate(states[0], caches);
+        caches.close_state_scope(states[0]);
+        EXPECT_EQ(caches.get_statistics()["numerical_denotation"].num_hits, 401);
+        EXPECT_GT(caches.compute_memory_usage(), memory_usage);
+    }
+
+    TEST(DLPTests, CachingPersistent)
+    {
+        auto vocabulary = std::make_shared<VocabularyInfo>();
+        auto predicate_0 = vocabulary->add_predicate("at", 1);
+        auto predicate_1 = vocabulary->add_predicate("conn", 2);
+        auto predicate_2 = vocabulary->add_predicate("road", 2, true);
+        auto make_instance = [&](int num_objects, int index) {
+            auto instance = std::make_shared<InstanceInfo>(vocabulary, index);
+            std::vector<Atom> atoms;
+            for (int i = 0; i < num_objects; ++i) {
+                instance->add_static_atom("road", {"o" + std::to_string(i), "o" + std::to_string((i + 1) % num_objects)});
+                atoms.push_back(instance->add_atom("at", {"o" + std::to_string(i)}));
+                atoms.push_back(instance->add_atom("conn", {"o" + std::to_string(i), "o" + std::to_string((i * 3 + 1) % num_objects)}));
+            }
+            States states;
+            for (int i = 0; i < 20; ++i) {
+                std::vector<Atom> state_atoms;
+                for (int j = 0; j < static_cast<int>(atoms.size()); ++j) {
+                    if ((i * 13 + j * 7) % 4 == 0) state_atoms.push_back(atoms[j]);
+                }
+                states.emplace_back(instance, state_atoms, i);
+            }
+            return states;
+        };
+        States states = make_instance(70, 0);
+        std::string filename = (std::filesystem::temp_directory_path() / "dlplan_caching_persistent.bin").string();
+
+        {
+            SyntacticElementFactory factory(vocabulary);
+            std::vector<std::shared_ptr<const BaseElement>> elements{
+                factory.parse_concept("c_and(c_some(r_primitive(road,0,1),c_top),c_primitive(at,0))"),
+                factory.parse_role("r_transitive_closure(r_primitive(conn,0,1))"),
+                factory.parse_boolean("b_empty(c_some(r_primitive(conn,0,1),c_primitive(at,0)))"),
+                factory.parse_numerical("n_count(c_some(r_primitive(conn,0,1),c_primitive(at,0)))"),
+            };
+            DenotationsCaches caches;
+            for (const auto& state : states) {
+                std::dynamic_pointer_cast<const Concept>(elements[0])->evaluate(state, caches);
+                std::dynamic_pointer_cast<const Role>(elements[1])->evaluate(state, caches);
+                std::dynamic_pointer_cast<const Boolean>(elements[2])->evaluate(state, caches);
+                std::dynamic_pointer_cast<const Numerical>(elements[3])->evaluate(state, caches);
+            }
+            caches.save(filename, elements, states);
+        }
+
+        // Another run creates the elements in a different order, such that their indices differ.
+        SyntacticElementFactory factory(vocabulary);
+        auto numerical = factory.parse_numerical("n_count(c_some(r_primitive(conn,0,1),c_primitive(at,0)))");
+        auto boolean = factory.parse_boolean("b_empty(c_some(r_primitive(conn,0,1),c_primitive(at,0)))");
+        auto role = factory.parse_role("r_transitive_closure(r_primitive(conn,0,1))");
+        auto concept_ = factory.parse_concept("c_and(c_some(r_primitive(road,0,1),c_top),c_primitive(at,0))");
+        DenotationsCaches caches;
+        caches.load(filename);
+        for (const auto& state : states) {
+            EXPECT_EQ(numerical->evaluate(state, caches), numerical->evaluate(state));
+            EXPECT_EQ(boolean->evaluate(state, caches), boolean->evaluate(state));
+            EXPECT_EQ(*role->evaluate(state, caches), role->evaluate(state));
+            EXPECT_EQ(*concept_->evaluate(state, caches), concept_->evaluate(state));
+        }
+        // Stored denotations are not computed, so no children were evaluated.
+        auto statistics = caches.get_statistics();
+        EXPECT_EQ(statistics["concept_denotation"].num_misses, 20);
+        EXPECT_EQ(statistics["role_denotation"].num_misses, 20);
+
+        // States of an instance with other objects are not in the file.
+        States other_states = make_instance(5, 1);
+        for (const auto& state : other_states) {
+            EXPECT_EQ(numerical->evaluate(state, caches), numerical->evaluate(state));
+        }
+        EXPECT_GT(caches.get_statistics()["concept_denotation"].num_misses, 40);
+
+        // A run that numbers the states differently does not find stale denotations.
+        States renumbered_states;
+        for (std::size_t i = 0; i < states.size(); ++i) {
+            renumbered_states.emplace_back(states[i].get_instance_info(), states[i].get_atom_indices(), states.size() - 1 - i);
+        }
+        DenotationsCaches renumbered_caches;
+        renumbered_caches.load(filename);
+        for (const auto& state : renumbered_states) {
+            EXPECT_EQ(numerical->evaluate(state, renumbered_caches), numerical->evaluate(state));
+        }
+        EXPECT_EQ(renumbered_caches.get_statistics()["concept_denotation"].num_misses, 40);
+
+        // Files whose records point outside of their sections are rejected.
+        std::string bytes;
+        {
+            std::ifstream file(filename, std::ios::binary);
+            bytes.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        }
+        auto write_file = [&](const std::string& content) {
+            std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+            file << content;
+        };
+        DenotationsFileHeader header;
+        std::memcpy(&header, bytes.data(), sizeof(header));
+        write_file(bytes.substr(0, bytes.size() / 2));
+        EXPECT_THROW(caches.load(filename), std::runtime_error);
+        std::string corrupted = bytes;
+        header.num_entries = std::numeric_limits<std::uint64_t>::max() / 2;
+        std::memcpy(&corrupted[0], &header, sizeof(header));
+        write_file(corrupted);
+        EXPECT_THROW(caches.load(filename), std::runtime_error);
+        corrupted = bytes;
+        std::size_t entries_begin = sizeof(DenotationsFileHeader) + (header.num_elements * sizeof(ElementRecord) + 7) / 8 * 8;
+        std::memcpy(&header, bytes.data(), sizeof(header));
+        for (std::uint64_t i = 0; i < header.num_entries; ++i) {
+            EntryRecord entry;
+            std::memcpy(&entry, &corrupted[entries_begin + i * sizeof(EntryRecord)], sizeof(entry));
+            entry.value = std::numeric_limits<std::uint32_t>::max();
+            std::memcpy(&corrupted[entries_begin + i * sizeof(EntryRecord)], &entry, sizeof(entry));
+        }
+        write_file(corrupted);
+        EXPECT_THROW(caches.load(filename), std::runtime_error);
+        write_file(bytes);
+        caches.load(filename);
+
+        write_file("not a denotations file");
+        EXPECT_THROW(caches.load(filename), std::runtime_error);
+        std::remove(filename.c_str());
+    }
+
+    TEST(DLPTests, CachingPersistentBatched)
+    {
+        auto vocabulary = std::make_shared<VocabularyInfo>();
+        auto predicate_0 = vocabulary->add_predicate("at", 1);
+        auto predicate_1 = vocabulary->add_predicate("conn", 2);
+        auto predicate_2 = vocabulary->add_predicate("road", 2, true);
+        auto instance = std::make_shared<InstanceInfo>(vocabulary, 0);
+        std::vector<Atom> atoms;
+        for (int i = 0; i < 30; ++i) {
+            instance->add_static_atom("road", {"o" + std::to_string(i), "o" + std::to_string((i + 1) % 30)});
+            atoms.push_back(instance->add_atom("at", {"o" + std::to_string(i)}));
+            atoms.push_back(instance->add_atom("conn", {"o" + std::to_string(i), "o" + std::to_string((i * 7 + 1) % 30)}));
+        }
+        States states;
+        for (int i = 0; i < 20; ++i) {
+            std::vector<Atom> state_atoms;
+            for (int j = 0; j < static_cast<int>(atoms.size()); ++j) {
+                if ((i * 11 + j * 5) % 3 == 0) state_atoms.push_back(atoms[j]);
+            }
+            states.emplace_back(instance, state_atoms, i);
+        }
+        std::vector<std::string> boolean_reprs{
+            "b_empty(c_some(r_primitive(conn,0,1),c_primitive(at,0)))",
+            "b_empty(c_and(c_some(r_primitive(road,0,1),c_top),c_primitive(at,0)))"};
+        std::vector<std::string> numerical_reprs{
+            "n_count(c_some(r_primitive(conn,0,1),c_primitive(at,0)))",
+            "n_count(c_all(r_inverse(r_primitive(conn,0,1)),c_primitive(at,0)))"};
+        std::string filename = (std::filesystem::temp_directory_path() / "dlplan_caching_persistent_batched.bin").string();
+
+        // Batched evaluation, as in feature generation, maps no state to a
+        // denotation. Save takes them from the collections in state order.
+        {
+            SyntacticElementFactory factory(vocabulary);
+            std::vector<std::shared_ptr<const BaseElement>> elements;
+            DenotationsCaches caches;
+            for (const auto& repr : boolean_reprs) {
+                auto boolean = factory.parse_boolean(repr);
+                boolean->evaluate(states, caches);
+                elements.push_back(boolean);
+            }
+            for (const auto& repr : numerical_reprs) {
+                auto numerical = factory.parse_numerical(repr);
+                numerical->evaluate(states, caches);
+                elements.push_back(numerical);
+            }
+            auto statistics = caches.get_statistics();
+            EXPECT_EQ(statistics["boolean_denotation"].num_bytes, 0);
+            EXPECT_EQ(statistics["numerical_denotation"].num_bytes, 0);
+            caches.save(filename, elements, states);
+        }
+
+        // Another run reads the batched denotations from the file.
+        SyntacticElementFactory factory(vocabulary);
+        std::vector<std::shared_ptr<const Boolean>> booleans;
+        std::vector<std::shared_ptr<const Numerical>> numericals;
+        for (auto it = numerical_reprs.rbegin(); it != numerical_reprs.rend(); ++it) {
+            numericals.insert(numericals.begin(), factory.parse_numerical(*it));
+        }
+        for (auto it = boolean_reprs.rbegin(); it != boolean_reprs.rend(); ++it) {
+            booleans.insert(booleans.begin(), factory.parse_boolean(*it));
+        }
+        DenotationsCaches caches;
+        caches.load(filename);
+        for (const auto& boolean : booleans) {
+            BooleanDenotations expected;
+            for (const auto& state : states) expected.push_back(boolean->evaluate(state));
+            EXPECT_EQ(*boolean->evaluate(states, caches), expected);
+        }
+        for (const auto& numerical : numericals) {
+            NumericalDenotations expected;
+            for (const auto& state : states) expected.push_back(numerical->evaluate(state));
+            EXPECT_EQ(*numerical->evaluate(states, caches), expected);
+        }
+        // Stored denotations are not computed, so no children were evaluated.
+        auto statistics = caches.get_statistics();
+        EXPECT_EQ(statistics["concept_denotations"].num_misses, 0);
+        EXPECT_EQ(statistics["role_denotations"].num_misses, 0);
+
+        // Stored denotations of a scoped state outlive the scope, because
+        // the collection of the batched evaluation points to them.
+        {
+            SyntacticElementFactory scoped_factory(vocabulary);
+            auto concept_ = scoped_factory.parse_concept("c_some(r_primitive(conn,0,1),c_primitive(at,0))");
+            auto role = scoped_factory.parse_role("r_inverse(r_primitive(conn,0,1))");
+            DenotationsCaches scoped_caches;
+            scoped_caches.load(filename);
+            scoped_caches.open_state_scope(states[0]);
+            concept_->evaluate(states, scoped_caches);
+            role->evaluate(states, scoped_caches);
+            scoped_caches.close_state_scope(states[0]);
+            const auto& concept_denotations = *concept_->evaluate(states, scoped_caches);
+            const auto& role_denotations = *role->evaluate(states, scoped_caches);
+            for (std::size_t i = 0; i < states.size(); ++i) {
+                EXPECT_EQ(*concept_denotations[i], concept_->evaluate(states[i]));
+                EXPECT_EQ(*role_denotations[i], role->evaluate(states[i]));
+            }
+            EXPECT_EQ(scoped_caches.get_statistics()["concept_denotations"].num_misses, 1);
+        }
+
+        // A program reads its outputs from the file and skips execution.
+        EvaluationProgram program(booleans, numericals);
+        DenotationsCaches program_caches;
+        program_caches.load(filename);
+        for (const auto& state : states) {
+            program.evaluate(state, program_caches);
+            for (std::size_t i = 0; i < booleans.size(); ++i) {
+                EXPECT_EQ(program.get_boolean_denotations()[i], booleans[i]->evaluate(state));
+            }
+            for (std::size_t i = 0; i < numericals.size(); ++i) {
+                EXPECT_EQ(program.get_numerical_denotations()[i], numericals[i]->evaluate(state));
+            }
+        }
+        EXPECT_EQ(program_caches.get_statistics()["numerical_denotation"].num_misses, 40);
+
+        // Without a file, a program inserts its outputs, such that they can be saved.
+        DenotationsCaches saved_caches;
+        for (const auto& state : states) {
+            program.evaluate(state, saved_caches);
+        }
+        std::vector<std::shared_ptr<const BaseElement>> elements(booleans.begin(), booleans.end());
+        elements.insert(elements.end(), numericals.begin(), numericals.end());
+        saved_caches.save(filename, elements, states);
+        DenotationsCaches loaded_caches;
+        loaded_caches.load(filename);
+        for (const auto& state : states) {
+            for (const auto& numerical : numericals) {
+                EXPECT_EQ(numerical->evaluate(state, loaded_caches), numerical->evaluate(state));
+            }
+        }
+        EXPECT_EQ(loaded_caches.get_statistics()["concept_denotation"].num_misses, 0);
+        std::remove(filename.c_str());
+    }
 }
@@ -15,4 +15,74 @@ TEST(DLPTests, ConceptDenotationComputeRepr) {
     EXPECT_EQ(denotation.compute_repr(), "ConceptDenotation(num_objects=4, object_indices=[0, 2])");
 }
 
+TEST(DLPTests, ConceptDenotationSizeAndToVector) {
+    int num_objects = 70;
+    ConceptDenotation denotation(num_objects);
+    EXPECT_EQ(denotation.size(), 0);
+    EXPECT_EQ(denotation.to_sorted_vector(), ObjectIndices());
+    denotation.insert(69);
+    denotation.insert(31);
+    denotation.insert(32);
+    denotation.insert(0);
+    EXPECT_EQ(denotation.size(), 4);
+    EXPECT_EQ(denotation.to_sorted_vector(), ObjectIndices({0, 31, 32, 69}));
+    ~denotation;
+    EXPECT_EQ(denotation.size(), num_objects - 4);
+    EXPECT_FALSE(denotation.contains(69));
+    EXPECT_TRUE(denotation.contains(68));
+    ConceptDenotation other(num_objects);
+    other.insert(0);
+    other.insert(1);
+    other.insert(68);
+    EXPECT_EQ(denotation.intersection_size(other), 2);
+}
+
+TEST(DLPTests, ConceptDenotationIterator) {
+    int num_objects = 130;
+    ConceptDenotation denotation(num_objects);
+    EXPECT_EQ(denotation.begin(), denotation.end());
+    denotation.insert(129);
+    denotation.insert(64);
+    denotation.insert(3);
+    EXPECT_EQ(ObjectIndices(denotation.begin(), denotation.end()), ObjectIndices({3, 64, 129}));
+    ObjectIndices visited;
+    denotation.for_each([&](ObjectIndex object) { visited.push_back(object); });
+    EXPECT_EQ(visited, denotation.to_sorted_vector());
+}
+
+TEST(DLPTests, ConceptDenotationCopyAndMove) {
+    // Up to 256 objects are stored inline, more objects on the heap.
+    for (int num_objects : {10, 256, 257, 1000}) {
+        ConceptDenotation denotation(num_objects);
+        denotation.insert(0);
+        denotation.insert(num_objects - 1);
+        ConceptDenotation copy(denotation);
+        EXPECT_EQ(copy, denotation);
+        copy.insert(num_objects / 2);
+        EXPECT_NE(copy, denotation);
+        ConceptDenotation moved(std::move(copy));
+        EXPECT_EQ(moved.to_sorted_vector(), ObjectIndices({0, num_objects / 2, num_objects - 1}));
+        ConceptDenotation assigned(1);
+        assigned = moved;
+        EXPECT_EQ(assigned, moved);
+        assigned = std::move(moved);
+        assigned &= denotation;
+        EXPECT_EQ(assigned, denotation);
+        EXPECT_EQ(assigned.hash(), denotation.hash());
+    }
+}
+
+TEST(DLPTests, ConceptDenotationHash) {
+    int num_objects = 300;
+    ConceptDenotation denotation(num_objects);
+    denotation.insert(7);
+    std::size_t hash = denotation.hash();
+    denotation.insert(299);
+    EXPECT_NE(denotation.hash(), hash);
+    denotation.erase(299);
+    EXPECT_EQ(denotation.hash(), hash);
+    ~denotation;
+    EXPECT_NE(denotation.hash(), hash);
+}
+
 }
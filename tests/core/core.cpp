@@ -61,4 +61,36 @@ TEST(DLPTests, InstanceCreation) {
     EXPECT_EQ(numerical->evaluate(state_3), 0);
 }
 
+TEST(DLPTests, AtomIndicesByPredicate) {
+    auto vocabulary = std::make_shared<VocabularyInfo>();
+    auto predicate_0 = vocabulary->add_predicate("on", 2);
+    auto predicate_1 = vocabulary->add_predicate("onTable", 1);
+    auto predicate_2 = vocabulary->add_predicate("on_g", 2);
+    auto predicate_3 = vocabulary->add_predicate("arm-empty", 0);
+    auto instance = std::make_shared<InstanceInfo>(vocabulary, 0);
+    auto atom_0 = instance->add_atom("on", {"A", "B"});
+    auto atom_1 = instance->add_atom("onTable", {"B"});
+    auto atom_2 = instance->add_atom("on", {"C", "A"});
+    auto atom_3 = instance->add_static_atom("on_g", {"A", "B"});
+    auto atom_4 = instance->add_static_atom("on", {"B", "C"});
+
+    EXPECT_EQ(instance->get_static_atom_indices(predicate_0.get_index()), AtomIndices({atom_4.get_index()}));
+    EXPECT_EQ(instance->get_static_atom_indices(predicate_2.get_index()), AtomIndices({atom_3.get_index()}));
+    EXPECT_TRUE(instance->get_static_atom_indices(predicate_1.get_index()).empty());
+
+    State state(instance, {atom_0, atom_1, atom_2}, 0);
+    EXPECT_EQ(state.get_atom_indices(predicate_0.get_index()), AtomIndices({atom_0.get_index(), atom_2.get_index()}));
+    EXPECT_EQ(state.get_atom_indices(predicate_1.get_index()), AtomIndices({atom_1.get_index()}));
+    EXPECT_TRUE(state.get_atom_indices(predicate_3.get_index()).empty());
+    // Copies share the index that was built before.
+    State copy(state);
+    EXPECT_EQ(&copy.get_atom_indices(predicate_0.get_index()), &state.get_atom_indices(predicate_0.get_index()));
+
+    // Primitives combine the atoms of the state with the static atoms of the instance.
+    SyntacticElementFactory factory(vocabulary);
+    EXPECT_EQ(factory.parse_concept("c_primitive(on,0)")->evaluate(state).size(), 3);
+    EXPECT_EQ(factory.parse_role("r_primitive(on,0,1)")->evaluate(state).size(), 3);
+    EXPECT_EQ(factory.parse_boolean("b_nullary(arm-empty)")->evaluate(state), false);
+}
+
 }
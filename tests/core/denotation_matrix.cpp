@@ -0,0 +1,79 @@
+#include <gtest/gtest.h>
+
+#include "../../include/dlplan/core.h"
+
+using namespace dlplan::core;
+
+
+namespace dlplan::core::tests {
+
+TEST(DLPTests, ConceptDenotationMatrix) {
+    // Rows of different instances have different numbers of objects.
+    ConceptDenotation denotation_0(70);
+    denotation_0.insert(0);
+    denotation_0.insert(69);
+    ConceptDenotation denotation_1(3);
+    denotation_1.insert(1);
+    ConceptDenotationMatrix matrix(ConceptDenotations{&denotation_0, &denotation_1});
+    EXPECT_EQ(matrix.get_num_rows(), 2);
+    EXPECT_EQ(matrix.get_num_objects(1), 3);
+    EXPECT_EQ(matrix.size(0), 2);
+    EXPECT_TRUE(matrix.contains(0, 69));
+    EXPECT_TRUE(matrix.contains(1, 1));
+    EXPECT_EQ(matrix.get_denotation(0), denotation_0);
+    EXPECT_EQ(matrix.get_denotation(1), denotation_1);
+
+    ConceptDenotationMatrix complement = matrix;
+    ~complement;
+    EXPECT_EQ(complement.size(0), 68);
+    EXPECT_EQ(complement.size(1), 2);
+    EXPECT_EQ(complement.get_denotation(1), ~ConceptDenotation(denotation_1));
+    EXPECT_NE(complement, matrix);
+
+    ConceptDenotationMatrix all = complement;
+    all |= matrix;
+    EXPECT_EQ(all.size(0), 70);
+    EXPECT_EQ(all.size(1), 3);
+    all -= complement;
+    EXPECT_EQ(all, matrix);
+    EXPECT_EQ(all.hash(), matrix.hash());
+    all &= complement;
+    EXPECT_EQ(all, ConceptDenotationMatrix(std::vector<int>{70, 3}));
+}
+
+TEST(DLPTests, RoleDenotationMatrix) {
+    // A sparse and a dense role denotation.
+    RoleDenotation denotation_0(3);
+    denotation_0.insert(std::make_pair(0, 2));
+    RoleDenotation denotation_1(70);
+    for (int i = 0; i < 70; ++i) {
+        for (int j = 0; j < 70; j += 2) {
+            denotation_1.insert(std::make_pair(i, j));
+        }
+    }
+    EXPECT_TRUE(denotation_1.is_dense());
+    RoleDenotationMatrix matrix(RoleDenotations{&denotation_0, &denotation_1});
+    EXPECT_EQ(matrix.size(0), 1);
+    EXPECT_EQ(matrix.size(1), 70 * 35);
+    EXPECT_TRUE(matrix.contains(0, std::make_pair(0, 2)));
+    EXPECT_TRUE(matrix.contains(1, std::make_pair(69, 68)));
+    EXPECT_FALSE(matrix.contains(1, std::make_pair(69, 69)));
+    EXPECT_EQ(matrix.get_denotation(0), denotation_0);
+    EXPECT_EQ(matrix.get_denotation(1), denotation_1);
+
+    RoleDenotationMatrix complement = matrix;
+    ~complement;
+    EXPECT_EQ(complement.size(0), 8);
+    EXPECT_EQ(complement.size(1), 70 * 35);
+    EXPECT_EQ(complement.get_denotation(0), ~RoleDenotation(denotation_0));
+    EXPECT_EQ(complement.get_denotation(1), ~RoleDenotation(denotation_1));
+
+    complement |= matrix;
+    EXPECT_EQ(complement.size(0), 9);
+    EXPECT_EQ(complement.size(1), 70 * 70);
+    complement -= matrix;
+    complement &= matrix;
+    EXPECT_EQ(complement, RoleDenotationMatrix(std::vector<int>{3, 70}));
+}
+
+}
@@ -0,0 +1,53 @@
+#include <gtest/gtest.h>
+
+#include "../../include/dlplan/utils/dynamic_bitset.h"
+
+#include <random>
+
+using namespace dlplan::utils;
+
+
+namespace dlplan::tests::core {
+
+using IncrementalBitset = DynamicBitset<std::uint64_t, 0, true>;
+
+static std::size_t recompute_hash(const IncrementalBitset& bitset) {
+    IncrementalBitset copy = bitset;
+    copy.recompute_hash();
+    return copy.hash();
+}
+
+TEST(DLPTests, DynamicBitsetIncrementalHash) {
+    // 300 bits span 5 blocks with unused bits in the last block.
+    int num_bits = 300;
+    std::mt19937 generator(0);
+    std::uniform_int_distribution<int> distribution(0, num_bits - 1);
+    IncrementalBitset bitset(num_bits);
+    IncrementalBitset other(num_bits);
+    EXPECT_EQ(bitset.hash(), recompute_hash(bitset));
+    for (int i = 0; i < 100; ++i) {
+        bitset.set(distribution(generator));
+        other.set(distribution(generator));
+        bitset.reset(distribution(generator));
+        EXPECT_EQ(bitset.hash(), recompute_hash(bitset));
+    }
+    bitset |= other;
+    EXPECT_EQ(bitset.hash(), recompute_hash(bitset));
+    bitset -= other;
+    EXPECT_EQ(bitset.hash(), recompute_hash(bitset));
+    ~bitset;
+    EXPECT_EQ(bitset.hash(), recompute_hash(bitset));
+    bitset &= other;
+    EXPECT_EQ(bitset.hash(), recompute_hash(bitset));
+    EXPECT_EQ(bitset, other);
+    EXPECT_EQ(bitset.hash(), other.hash());
+    bitset.or_assign(2, other.data(), 3);
+    EXPECT_EQ(bitset.hash(), recompute_hash(bitset));
+    bitset.set();
+    EXPECT_EQ(bitset.count(), num_bits);
+    EXPECT_EQ(bitset.hash(), recompute_hash(bitset));
+    bitset.reset();
+    EXPECT_EQ(bitset.hash(), IncrementalBitset(num_bits).hash());
+}
+
+}
@@ -0,0 +1,164 @@
+#include <gtest/gtest.h>
+
+#include "../../include/dlplan/core.h"
+
+using namespace dlplan::core;
+
+
+namespace dlplan::tests::core {
+
+TEST(DLPTests, EvaluationProgram) {
+    auto vocabulary = std::make_shared<VocabularyInfo>();
+    vocabulary->add_predicate("conn", 2, true);
+    vocabulary->add_predicate("at", 1);
+    vocabulary->add_predicate("painted", 1);
+    vocabulary->add_predicate("holding", 0);
+    vocabulary->add_constant("A");
+
+    // Instance with path A->B->C->D
+    auto instance_0 = std::make_shared<InstanceInfo>(vocabulary, 0);
+    instance_0->add_static_atom("conn", {"A", "B"});
+    instance_0->add_static_atom("conn", {"B", "C"});
+    instance_0->add_static_atom("conn", {"C", "D"});
+    auto atom_0_0 = instance_0->add_atom("at", {"A"});
+    auto atom_0_1 = instance_0->add_atom("at", {"C"});
+    auto atom_0_2 = instance_0->add_atom("painted", {"B"});
+    auto atom_0_3 = instance_0->add_atom("painted", {"D"});
+    auto atom_0_4 = instance_0->add_atom("holding", {});
+    States states_0{
+        State(instance_0, std::vector<Atom>{}, 0),
+        State(instance_0, {atom_0_0, atom_0_2}, 1),
+        State(instance_0, {atom_0_1, atom_0_3, atom_0_4}, 2),
+        State(instance_0, {atom_0_0, atom_0_1, atom_0_2, atom_0_3}, 3)};
+
+    // Instance with cycle A->E->A and a different number of objects
+    auto instance_1 = std::make_shared<InstanceInfo>(vocabulary, 1);
+    instance_1->add_static_atom("conn", {"A", "E"});
+    instance_1->add_static_atom("conn", {"E", "A"});
+    auto atom_1_0 = instance_1->add_atom("at", {"E"});
+    auto atom_1_1 = instance_1->add_atom("painted", {"A"});
+    States states_1{
+        State(instance_1, {atom_1_0}, 0),
+        State(instance_1, {atom_1_0, atom_1_1}, 1)};
+
+    SyntacticElementFactory factory(vocabulary);
+    std::vector<std::shared_ptr<const Boolean>> booleans{
+        factory.parse_boolean("b_empty(c_and(c_primitive(at,0),c_primitive(painted,0)))"),
+        factory.parse_boolean("b_empty(r_restrict(r_primitive(conn,0,1),c_primitive(at,0)))"),
+        factory.parse_boolean("b_inclusion(c_primitive(painted,0),c_some(r_primitive(conn,0,1),c_primitive(at,0)))"),
+        factory.parse_boolean("b_inclusion(r_identity(c_primitive(at,0)),r_transitive_reflexive_closure(r_primitive(conn,0,1)))"),
+        factory.parse_boolean("b_nullary(holding)"),
+    };
+    std::vector<std::shared_ptr<const Numerical>> numericals{
+        factory.parse_numerical("n_count(c_or(c_primitive(at,0),c_primitive(painted,0)))"),
+        factory.parse_numerical("n_count(c_all(r_primitive(conn,0,1),c_primitive(painted,0)))"),
+        factory.parse_numerical("n_count(c_diff(c_top,c_primitive(at,0)))"),
+        factory.parse_numerical("n_count(c_not(c_equal(r_primitive(conn,0,1),r_primitive(conn,0,1))))"),
+        factory.parse_numerical("n_count(c_subset(r_primitive(conn,0,1),r_top))"),
+        factory.parse_numerical("n_count(c_projection(r_transitive_closure(r_primitive(conn,0,1)),1))"),
+        factory.parse_numerical("n_count(c_or(c_bot,c_one_of(A)))"),
+        factory.parse_numerical("n_count(r_and(r_inverse(r_primitive(conn,0,1)),r_or(r_top,r_identity(c_primitive(at,0)))))"),
+        factory.parse_numerical("n_count(r_diff(r_not(r_primitive(conn,0,1)),r_compose(r_primitive(conn,0,1),r_primitive(conn,0,1))))"),
+        factory.parse_numerical("n_concept_distance(c_primitive(at,0),r_primitive(conn,0,1),c_primitive(painted,0))"),
+        factory.parse_numerical("n_sum_concept_distance(c_primitive(at,0),r_primitive(conn,0,1),c_primitive(painted,0))"),
+        factory.parse_numerical("n_role_distance(r_identity(c_primitive(at,0)),r_primitive(conn,0,1),r_identity(c_primitive(painted,0)))"),
+        factory.parse_numerical("n_sum_role_distance(r_identity(c_primitive(at,0)),r_primitive(conn,0,1),r_identity(c_primitive(painted,0)))"),
+    };
+
+    EvaluationProgram program(booleans, numericals);
+    // Alternate between instances to recompute the static instructions.
+    for (const auto& states : {states_0, states_1, states_0}) {
+        for (const auto& state : states) {
+            program.evaluate(state);
+            for (std::size_t i = 0; i < booleans.size(); ++i) {
+                EXPECT_EQ(program.get_boolean_denotations()[i], booleans[i]->evaluate(state));
+            }
+            for (std::size_t i = 0; i < numericals.size(); ++i) {
+                EXPECT_EQ(program.get_numerical_denotations()[i], numericals[i]->evaluate(state));
+            }
+        }
+    }
+}
+
+TEST(DLPTests, EvaluationProgramSharing) {
+    auto vocabulary = std::make_shared<VocabularyInfo>();
+    vocabulary->add_predicate("conn", 2, true);
+    vocabulary->add_predicate("at", 1);
+    vocabulary->add_predicate("painted", 1);
+    auto instance = std::make_shared<InstanceInfo>(vocabulary, 0);
+    instance->add_static_atom("conn", {"A", "B"});
+    auto atom_0 = instance->add_atom("at", {"A"});
+    auto atom_1 = instance->add_atom("painted", {"B"});
+    State state(instance, {atom_0, atom_1}, 0);
+
+    SyntacticElementFactory factory(vocabulary);
+    // Shared subexpressions are compiled once and n_count(c_some(...)) is fused.
+    std::vector<std::shared_ptr<const Numerical>> numericals{
+        factory.parse_numerical("n_count(c_some(r_primitive(conn,0,1),c_primitive(at,0)))"),
+        factory.parse_numerical("n_count(c_all(r_primitive(conn,0,1),c_primitive(at,0)))"),
+        factory.parse_numerical("n_count(c_primitive(at,0))"),
+    };
+    EvaluationProgram program({}, numericals);
+    EXPECT_EQ(program.get_num_instructions(), 6);
+    program.evaluate(state);
+    EXPECT_EQ(program.get_numerical_denotations(), NumericalDenotations({0, 1, 1}));
+
+    // A chain of dynamic concepts reuses registers.
+    std::string description = "c_primitive(at,0)";
+    for (int i = 0; i < 10; ++i) {
+        description = "c_not(c_or(" + description + ",c_primitive(painted,0)))";
+    }
+    EvaluationProgram chain({}, {factory.parse_numerical("n_count(" + description + ")")});
+    EXPECT_EQ(chain.get_num_instructions(), 23);
+    EXPECT_LE(chain.get_num_registers(), 3);
+    chain.evaluate(state);
+    EXPECT_EQ(chain.get_numerical_denotations()[0], factory.parse_numerical("n_count(" + description + ")")->evaluate(state));
+}
+
+TEST(DLPTests, EvaluationProgramFusion) {
+    auto vocabulary = std::make_shared<VocabularyInfo>();
+    vocabulary->add_predicate("conn", 2, true);
+    vocabulary->add_predicate("on", 2);
+    vocabulary->add_predicate("at", 1);
+    vocabulary->add_predicate("painted", 1);
+    auto instance = std::make_shared<InstanceInfo>(vocabulary, 0);
+    instance->add_static_atom("conn", {"A", "B"});
+    instance->add_static_atom("conn", {"B", "C"});
+    auto atom_0 = instance->add_atom("on", {"A", "B"});
+    auto atom_1 = instance->add_atom("on", {"C", "B"});
+    auto atom_2 = instance->add_atom("at", {"A"});
+    auto atom_3 = instance->add_atom("at", {"B"});
+    auto atom_4 = instance->add_atom("painted", {"B"});
+    States states{
+        State(instance, std::vector<Atom>{}, 0),
+        State(instance, {atom_0, atom_2}, 1),
+        State(instance, {atom_0, atom_1, atom_3, atom_4}, 2),
+        State(instance, {atom_1, atom_2, atom_4}, 3)};
+
+    SyntacticElementFactory factory(vocabulary);
+    // Each shape is fused into a single instruction over its leaves.
+    std::vector<std::shared_ptr<const Boolean>> booleans{
+        factory.parse_boolean("b_empty(c_some(r_primitive(on,0,1),c_primitive(painted,0)))"),
+        factory.parse_boolean("b_empty(c_some(r_primitive(conn,0,1),c_primitive(at,0)))"),
+        factory.parse_boolean("b_empty(c_and(c_primitive(at,0),c_primitive(painted,0)))"),
+    };
+    std::vector<std::shared_ptr<const Numerical>> numericals{
+        factory.parse_numerical("n_count(c_some(r_primitive(on,1,0),c_primitive(at,0)))"),
+        factory.parse_numerical("n_count(c_some(r_primitive(conn,1,0),c_primitive(at,0)))"),
+        factory.parse_numerical("n_count(c_and(c_primitive(at,0),c_primitive(on,0)))"),
+    };
+    EvaluationProgram program(booleans, numericals);
+    // 2 static roles, 3 concepts, 3 booleans, 3 numericals, and c_some of n_count over r_primitive(on,1,0).
+    EXPECT_EQ(program.get_num_instructions(), 12);
+    for (const auto& state : states) {
+        program.evaluate(state);
+        for (std::size_t i = 0; i < booleans.size(); ++i) {
+            EXPECT_EQ(program.get_boolean_denotations()[i], booleans[i]->evaluate(state));
+        }
+        for (std::size_t i = 0; i < numericals.size(); ++i) {
+            EXPECT_EQ(program.get_numerical_denotations()[i], numericals[i]->evaluate(state));
+        }
+    }
+}
+
+}
@@ -15,4 +15,250 @@ TEST(DLPTests, RoleDenotationComputeRepr) {
     EXPECT_EQ(denotation.compute_repr(), "RoleDenotation(num_objects=4, pairs_of_object_indices=[<0,1>, <1,2>])");
 }
 
+TEST(DLPTests, RoleDenotationSizeAndToVector) {
+    // 37 * 37 bits span several blocks and leave unused bits in the last block.
+    int num_objects = 37;
+    RoleDenotation denotation(num_objects);
+    EXPECT_EQ(denotation.size(), 0);
+    EXPECT_EQ(denotation.to_sorted_vector(), PairsOfObjectIndices());
+    PairsOfObjectIndices expected = {{0,0}, {0,36}, {1,0}, {17,31}, {36,35}, {36,36}};
+    for (const auto& pair : expected) {
+        denotation.insert(pair);
+    }
+    EXPECT_EQ(denotation.size(), 6);
+    EXPECT_EQ(denotation.to_sorted_vector(), expected);
+    denotation.set();
+    EXPECT_EQ(denotation.size(), num_objects * num_objects);
+    EXPECT_EQ(static_cast<int>(denotation.to_sorted_vector().size()), num_objects * num_objects);
+}
+
+TEST(DLPTests, RoleDenotationSetAlgebra) {
+    // Large enough that the vectorized block kernels are used.
+    int num_objects = 37;
+    RoleDenotation left(num_objects);
+    RoleDenotation right(num_objects);
+    for (int i = 0; i < num_objects; ++i) {
+        for (int j = 0; j < num_objects; ++j) {
+            if ((i + j) % 3 == 0) left.insert({i, j});
+            if ((i * j) % 2 == 0) right.insert({i, j});
+        }
+    }
+    RoleDenotation intersection = left;
+    intersection &= right;
+    RoleDenotation union_ = left;
+    union_ |= right;
+    RoleDenotation difference = left;
+    difference -= right;
+    RoleDenotation complement = left;
+    ~complement;
+    for (int i = 0; i < num_objects; ++i) {
+        for (int j = 0; j < num_objects; ++j) {
+            bool in_left = left.contains({i, j});
+            bool in_right = right.contains({i, j});
+            EXPECT_EQ(intersection.contains({i, j}), in_left && in_right);
+            EXPECT_EQ(union_.contains({i, j}), in_left || in_right);
+            EXPECT_EQ(difference.contains({i, j}), in_left && !in_right);
+            EXPECT_EQ(complement.contains({i, j}), !in_left);
+        }
+    }
+    EXPECT_EQ(complement.size(), num_objects * num_objects - left.size());
+    EXPECT_TRUE(left.intersects(right));
+    EXPECT_FALSE(left.intersects(complement));
+    EXPECT_TRUE(intersection.is_subset_of(left));
+    EXPECT_TRUE(left.is_subset_of(union_));
+    EXPECT_FALSE(union_.is_subset_of(left));
+}
+
+TEST(DLPTests, RoleDenotationIterator) {
+    int num_objects = 9;
+    RoleDenotation denotation(num_objects);
+    EXPECT_EQ(denotation.begin(), denotation.end());
+    denotation.insert({8,8});
+    denotation.insert({7,1});
+    denotation.insert({0,3});
+    EXPECT_EQ(PairsOfObjectIndices(denotation.begin(), denotation.end()), PairsOfObjectIndices({{0,3}, {7,1}, {8,8}}));
+    PairsOfObjectIndices visited;
+    denotation.for_each([&](ObjectIndex source, ObjectIndex target) { visited.emplace_back(source, target); });
+    EXPECT_EQ(visited, denotation.to_sorted_vector());
+}
+
+TEST(DLPTests, RoleDenotationRows) {
+    // Rows of 5 objects fit into a single block, rows of 300 objects use the vectorized kernels.
+    for (int num_objects : {5, 300}) {
+        RoleDenotation role(num_objects);
+        role.insert({0, 1});
+        role.insert({0, num_objects - 1});
+        role.insert({2, 1});
+        ConceptDenotation concept(num_objects);
+        concept.insert(1);
+        EXPECT_EQ(role.get_successors(0).to_sorted_vector(), ObjectIndices({1, num_objects - 1}));
+        EXPECT_EQ(role.get_predecessors(1).to_sorted_vector(), ObjectIndices({0, 2}));
+        EXPECT_TRUE(role.has_successors(0));
+        EXPECT_FALSE(role.has_successors(1));
+        EXPECT_TRUE(role.successors_intersect(0, concept));
+        EXPECT_FALSE(role.successors_are_subset_of(0, concept));
+        EXPECT_TRUE(role.successors_are_subset_of(2, concept));
+        EXPECT_TRUE(role.successors_are_subset_of(1, concept));
+        // Modifications invalidate the transposed matrix.
+        role.insert_successors(3, concept);
+        EXPECT_EQ(role.get_predecessors(1).to_sorted_vector(), ObjectIndices({0, 2, 3}));
+        role.insert_successors(4, role, 0);
+        EXPECT_EQ(role.get_successors(4), role.get_successors(0));
+        role.restrict_successors(4, concept);
+        EXPECT_EQ(role.get_predecessors(num_objects - 1).to_sorted_vector(), ObjectIndices({0}));
+        // Padding bits in each row remain unset.
+        ~role;
+        EXPECT_EQ(role.size(), num_objects * num_objects - 5);
+        role.set();
+        EXPECT_EQ(role.size(), num_objects * num_objects);
+        EXPECT_EQ(role.get_predecessors(1).size(), num_objects);
+    }
+}
+
+TEST(DLPTests, RoleDenotationRepresentation) {
+    // With 100 objects, up to 25 pairs are stored in the sparse representation.
+    int num_objects = 100;
+    RoleDenotation sparse(num_objects);
+    for (int i = 0; i < 25; ++i) {
+        sparse.insert({i, 99 - i});
+    }
+    EXPECT_FALSE(sparse.is_dense());
+    RoleDenotation dense = sparse;
+    dense.insert({50, 50});
+    EXPECT_TRUE(dense.is_dense());
+    EXPECT_LT(sparse.compute_memory_usage(), dense.compute_memory_usage());
+    // Equal denotations obtained through different representations are equal and have equal hashes.
+    RoleDenotation complement = sparse;
+    ~complement;
+    EXPECT_TRUE(complement.is_dense());
+    ~complement;
+    EXPECT_EQ(complement, sparse);
+    EXPECT_EQ(complement.hash(), sparse.hash());
+    RoleDenotation difference = dense;
+    difference.erase({50, 50});
+    EXPECT_EQ(difference, sparse);
+    EXPECT_EQ(difference.hash(), sparse.hash());
+    RoleDenotation intersection(num_objects);
+    intersection.set();
+    intersection &= sparse;
+    EXPECT_EQ(intersection, sparse);
+    RoleDenotation union_ = sparse;
+    union_ |= dense;
+    EXPECT_EQ(union_, dense);
+    EXPECT_EQ(union_.hash(), dense.hash());
+    EXPECT_TRUE(sparse.is_subset_of(dense));
+    EXPECT_FALSE(dense.is_subset_of(sparse));
+    EXPECT_TRUE(sparse.intersects(dense));
+    EXPECT_EQ(PairsOfObjectIndices(dense.begin(), dense.end()), dense.to_sorted_vector());
+    EXPECT_EQ(PairsOfObjectIndices(sparse.begin(), sparse.end()), sparse.to_sorted_vector());
+}
+
+TEST(DLPTests, RoleDenotationTransitiveClosure) {
+    // Compare against a breadth-first search from every object on sparse and dense random graphs.
+    int num_objects = 70;
+    for (int num_pairs : {0, 10, 15, 100, 3000}) {
+        RoleDenotation denotation(num_objects);
+        unsigned seed = num_pairs;
+        for (int i = 0; i < num_pairs; ++i) {
+            seed = seed * 1103515245 + 12345;
+            int source = (seed >> 8) % num_objects;
+            seed = seed * 1103515245 + 12345;
+            int target = (seed >> 8) % num_objects;
+            denotation.insert({source, target});
+        }
+        RoleDenotation expected(num_objects);
+        for (int source = 0; source < num_objects; ++source) {
+            std::vector<int> queue{source};
+            for (std::size_t i = 0; i < queue.size(); ++i) {
+                for (int target = 0; target < num_objects; ++target) {
+                    if (denotation.contains({queue[i], target}) && !expected.contains({source, target})) {
+                        expected.insert({source, target});
+                        queue.push_back(target);
+                    }
+                }
+            }
+        }
+        RoleDenotation closure = denotation;
+        closure.transitive_closure();
+        EXPECT_EQ(closure, expected);
+        EXPECT_TRUE(denotation.is_subset_of(closure));
+        RoleDenotation twice = closure;
+        twice.transitive_closure();
+        EXPECT_EQ(twice, closure);
+    }
+    // A cycle closes into the complete relation over its objects.
+    RoleDenotation cycle(num_objects);
+    cycle.insert({3, 5});
+    cycle.insert({5, 7});
+    cycle.insert({7, 3});
+    cycle.insert({7, 10});
+    cycle.transitive_closure();
+    EXPECT_EQ(cycle.size(), 12);
+    EXPECT_TRUE(cycle.contains({3, 3}));
+    EXPECT_TRUE(cycle.contains({5, 10}));
+    EXPECT_FALSE(cycle.contains({10, 10}));
+}
+
+TEST(DLPTests, RoleDenotationComposition) {
+    // Compare against the definition for all combinations of representations.
+    int num_objects = 70;
+    for (int num_left_pairs : {5, 3000}) {
+        for (int num_right_pairs : {5, 100, 3000}) {
+            RoleDenotation left(num_objects);
+            RoleDenotation right(num_objects);
+            unsigned seed = num_left_pairs + num_right_pairs;
+            for (int i = 0; i < std::max(num_left_pairs, num_right_pairs); ++i) {
+                seed = seed * 1103515245 + 12345;
+                int source = (seed >> 8) % num_objects;
+                seed = seed * 1103515245 + 12345;
+                int target = (seed >> 8) % num_objects;
+                if (i < num_left_pairs) left.insert({source, target});
+                if (i < num_right_pairs) right.insert({target, source});
+            }
+            RoleDenotation expected(num_objects);
+            for (const auto& left_pair : left.to_sorted_vector()) {
+                for (const auto& right_pair : right.to_sorted_vector()) {
+                    if (left_pair.second == right_pair.first) {
+                        expected.insert({left_pair.first, right_pair.second});
+                    }
+                }
+            }
+            RoleDenotation result(num_objects);
+            result.insert_composition(left, right);
+            EXPECT_EQ(result, expected);
+            EXPECT_EQ(result.hash(), expected.hash());
+            // Pairs that are already present are kept.
+            RoleDenotation extended(num_objects);
+            extended.insert({69, 69});
+            extended.insert_composition(left, right);
+            expected.insert({69, 69});
+            EXPECT_EQ(extended, expected);
+        }
+    }
+}
+
+TEST(DLPTests, RoleDenotationSuccessorsOfSet) {
+    int num_objects = 70;
+    RoleDenotation sparse(num_objects);
+    sparse.insert({0, 1});
+    sparse.insert({2, 69});
+    sparse.insert({3, 4});
+    RoleDenotation dense = sparse;
+    for (int i = 0; i < num_objects; ++i) {
+        dense.insert({i + 10 < num_objects ? i + 10 : i, 5});
+    }
+    EXPECT_TRUE(dense.is_dense());
+    ConceptDenotation objects(num_objects);
+    objects.insert(0);
+    objects.insert(2);
+    for (const auto* denotation : {&sparse, &dense}) {
+        ConceptDenotation successors = denotation->get_successors(objects);
+        EXPECT_EQ(successors.to_sorted_vector(), ObjectIndices({1, 69}));
+        ConceptDenotation targets(num_objects);
+        targets.insert(1);
+        targets.insert(4);
+        EXPECT_EQ(denotation->get_predecessors(targets).to_sorted_vector(), ObjectIndices({0, 3}));
+    }
+}
+
 }